@@ -0,0 +1,78 @@
+// generated by src/gen-builtins.c from src/parser/builtins.h; do not edit
+#ifndef _BUILTIN_NAMES_H
+#define _BUILTIN_NAMES_H
+
+#define BUILTIN_NAMES_LEN 20
+#define BUILTIN_NAMES_DATA_LEN 90
+#define BUILTIN_NAMES_SLOTS_CAP 64
+
+static const char builtin_names_data[BUILTIN_NAMES_DATA_LEN + 1] =
+	"i8\0"
+	"i16\0"
+	"i32\0"
+	"i64\0"
+	"isize\0"
+	"u8\0"
+	"u16\0"
+	"u32\0"
+	"u64\0"
+	"usize\0"
+	"f16\0"
+	"f32\0"
+	"f64\0"
+	"f64x\0"
+	"type\0"
+	"void\0"
+	"bool\0"
+	"true\0"
+	"false\0"
+	"null\0"
+;
+
+static const struct StrPoolEntry builtin_names_entries[BUILTIN_NAMES_LEN] = {
+	{ .offset = 0, .len = 2, .hash = 0xb0e090f5u },
+	{ .offset = 3, .len = 3, .hash = 0x603a3993u },
+	{ .offset = 7, .len = 3, .hash = 0x376753cbu },
+	{ .offset = 11, .len = 3, .hash = 0xacfe2abau },
+	{ .offset = 15, .len = 5, .hash = 0xb9dd2644u },
+	{ .offset = 21, .len = 2, .hash = 0xf6b4321fu },
+	{ .offset = 24, .len = 3, .hash = 0xf3022bf9u },
+	{ .offset = 28, .len = 3, .hash = 0xc58cac01u },
+	{ .offset = 32, .len = 3, .hash = 0x6ed63710u },
+	{ .offset = 36, .len = 5, .hash = 0x0b46e0c2u },
+	{ .offset = 42, .len = 3, .hash = 0xc5270284u },
+	{ .offset = 46, .len = 3, .hash = 0x9e91c8bfu },
+	{ .offset = 50, .len = 3, .hash = 0x13732dadu },
+	{ .offset = 54, .len = 4, .hash = 0xd8b84344u },
+	{ .offset = 59, .len = 4, .hash = 0xca626c09u },
+	{ .offset = 64, .len = 4, .hash = 0x3f9d1188u },
+	{ .offset = 69, .len = 4, .hash = 0x02d989f0u },
+	{ .offset = 74, .len = 4, .hash = 0x5fe413adu },
+	{ .offset = 79, .len = 5, .hash = 0xb6e7b023u },
+	{ .offset = 85, .len = 4, .hash = 0xaa244a8eu },
+};
+
+static const uint32_t builtin_names_slots[BUILTIN_NAMES_SLOTS_CAP] = {
+	[1] = 8,
+	[2] = 10,
+	[4] = 5,
+	[5] = 11,
+	[6] = 14,
+	[8] = 16,
+	[9] = 15,
+	[11] = 3,
+	[14] = 20,
+	[16] = 9,
+	[19] = 2,
+	[31] = 6,
+	[35] = 19,
+	[45] = 13,
+	[46] = 18,
+	[48] = 17,
+	[53] = 1,
+	[57] = 7,
+	[58] = 4,
+	[63] = 12,
+};
+
+#endif
@@ -0,0 +1,127 @@
+// generated by src/gen-keywords.c from src/tokenizer/keywords.h; do not edit
+#ifndef _KEYWORD_HASH_H
+#define _KEYWORD_HASH_H
+
+#define KEYWORD_TABLE_LEN 64
+#define KEYWORD_MIN_LEN 2
+#define KEYWORD_MAX_LEN 8
+#define KEYWORD_HASH(len, first, last) (((unsigned)(first) * 5u + (unsigned)(last) * 43u + (unsigned)(len)) & (KEYWORD_TABLE_LEN - 1))
+
+static const char* const keywords[KEYWORD_TABLE_LEN] = {
+	[1] = "struct",
+	[8] = "union",
+	[12] = "enum",
+	[27] = "let",
+	[32] = "mut",
+	[35] = "func",
+	[38] = "static",
+	[39] = "for",
+	[40] = "break",
+	[41] = "pub",
+	[42] = "case",
+	[44] = "goto",
+	[46] = "continue",
+	[48] = "const",
+	[49] = "if",
+	[50] = "vec",
+	[52] = "else",
+	[56] = "ext",
+	[58] = "return",
+	[61] = "switch",
+	[62] = "restrict",
+	[63] = "type",
+};
+
+static const unsigned char keyword_lens[KEYWORD_TABLE_LEN] = {
+	[1] = 6,
+	[8] = 5,
+	[12] = 4,
+	[27] = 3,
+	[32] = 3,
+	[35] = 4,
+	[38] = 6,
+	[39] = 3,
+	[40] = 5,
+	[41] = 3,
+	[42] = 4,
+	[44] = 4,
+	[46] = 8,
+	[48] = 5,
+	[49] = 2,
+	[50] = 3,
+	[52] = 4,
+	[56] = 3,
+	[58] = 6,
+	[61] = 6,
+	[62] = 8,
+	[63] = 4,
+};
+
+static const TokenType keyword_tokens[KEYWORD_TABLE_LEN] = {
+	[0] = TOKEN_IDENT,
+	[1] = TOKEN_STRUCT,
+	[2] = TOKEN_IDENT,
+	[3] = TOKEN_IDENT,
+	[4] = TOKEN_IDENT,
+	[5] = TOKEN_IDENT,
+	[6] = TOKEN_IDENT,
+	[7] = TOKEN_IDENT,
+	[8] = TOKEN_UNION,
+	[9] = TOKEN_IDENT,
+	[10] = TOKEN_IDENT,
+	[11] = TOKEN_IDENT,
+	[12] = TOKEN_ENUM,
+	[13] = TOKEN_IDENT,
+	[14] = TOKEN_IDENT,
+	[15] = TOKEN_IDENT,
+	[16] = TOKEN_IDENT,
+	[17] = TOKEN_IDENT,
+	[18] = TOKEN_IDENT,
+	[19] = TOKEN_IDENT,
+	[20] = TOKEN_IDENT,
+	[21] = TOKEN_IDENT,
+	[22] = TOKEN_IDENT,
+	[23] = TOKEN_IDENT,
+	[24] = TOKEN_IDENT,
+	[25] = TOKEN_IDENT,
+	[26] = TOKEN_IDENT,
+	[27] = TOKEN_LET,
+	[28] = TOKEN_IDENT,
+	[29] = TOKEN_IDENT,
+	[30] = TOKEN_IDENT,
+	[31] = TOKEN_IDENT,
+	[32] = TOKEN_MUT,
+	[33] = TOKEN_IDENT,
+	[34] = TOKEN_IDENT,
+	[35] = TOKEN_FUNC,
+	[36] = TOKEN_IDENT,
+	[37] = TOKEN_IDENT,
+	[38] = TOKEN_STATIC,
+	[39] = TOKEN_FOR,
+	[40] = TOKEN_BREAK,
+	[41] = TOKEN_PUB,
+	[42] = TOKEN_CASE,
+	[43] = TOKEN_IDENT,
+	[44] = TOKEN_GOTO,
+	[45] = TOKEN_IDENT,
+	[46] = TOKEN_CONTINUE,
+	[47] = TOKEN_IDENT,
+	[48] = TOKEN_CONST,
+	[49] = TOKEN_IF,
+	[50] = TOKEN_VEC,
+	[51] = TOKEN_IDENT,
+	[52] = TOKEN_ELSE,
+	[53] = TOKEN_IDENT,
+	[54] = TOKEN_IDENT,
+	[55] = TOKEN_IDENT,
+	[56] = TOKEN_EXT,
+	[57] = TOKEN_IDENT,
+	[58] = TOKEN_RETURN,
+	[59] = TOKEN_IDENT,
+	[60] = TOKEN_IDENT,
+	[61] = TOKEN_SWITCH,
+	[62] = TOKEN_RESTRICT,
+	[63] = TOKEN_TYPE,
+};
+
+#endif
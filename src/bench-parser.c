@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "parser/parser.h"
+#include "parser/nodes/op_binary.h"
+
+// snippet throughput: parses a set of small expressions over and over,
+// once with a fresh parser per snippet (parser_init/parser_free) and
+// once with one parser reused through parser_reset, and reports the
+// time and heap allocations per snippet. after a warm-up pass the
+// reused parser should allocate nothing.
+//     bench-parser [ROUNDS]
+//
+// linked with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc so that
+// every allocation goes through the counters below.
+
+static size_t allocs = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+	allocs++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+	allocs++;
+	return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+	allocs++;
+	return __real_realloc(ptr, size);
+}
+
+static const char* const SNIPPETS[] = {
+	"*u32",
+	"1 + 2 * 3",
+	"(1 + 2) * (3 - 4) / 5",
+	"true && false || !true",
+	"1.5 + 2.25 * 4.0",
+	"\"hello\" == \"world\"",
+	"&1 == &2",
+	"*&true",
+	"-1 + ~2 - (3 + 4 + 5 + 6 + 7 + 8 + 9)",
+	"false || true && (true || false)",
+};
+#define SNIPPETS_LEN (sizeof(SNIPPETS) / sizeof(*SNIPPETS))
+
+static double now_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void parse(Parser* parser, const char* src) {
+	NodeRef root = node_op_binary_parse(parser);
+	if (root == NODE_ERR || !parser_peek_is(parser, TOKEN_EOF)) {
+		fprintf(stderr, "failed to parse \"%s\": %s\n", src, parser->error != NULL ? parser->error : "trailing tokens");
+		exit(1);
+	}
+}
+
+static void report(const char* name, size_t count, double ms, size_t allocs) {
+	printf("%-7s %zu snippets in %.1f ms: %.0f ns/snippet, %.3f allocations/snippet\n",
+		name, count, ms, ms * 1e6 / count, (double)allocs / count);
+}
+
+int main(int argc, char** argv) {
+	size_t rounds = argc > 1 ? atol(argv[1]) : 100000;
+	size_t count = rounds * SNIPPETS_LEN;
+
+	for (int run = 0; run < 3; run++) {
+		size_t before = allocs;
+		double start = now_ms();
+		for (size_t round = 0; round < rounds; round++) {
+			for (size_t i = 0; i < SNIPPETS_LEN; i++) {
+				Parser parser;
+				parser_init(&parser, SNIPPETS[i]);
+				parse(&parser, SNIPPETS[i]);
+				parser_free(&parser);
+			}
+		}
+		report("init", count, now_ms() - start, allocs - before);
+
+		// one pass to grow everything to the snippets' high-water mark
+		Parser parser;
+		parser_init(&parser, SNIPPETS[0]);
+		for (size_t i = 0; i < SNIPPETS_LEN; i++) {
+			parser_reset(&parser, SNIPPETS[i]);
+			parse(&parser, SNIPPETS[i]);
+		}
+
+		before = allocs;
+		start = now_ms();
+		for (size_t round = 0; round < rounds; round++) {
+			for (size_t i = 0; i < SNIPPETS_LEN; i++) {
+				parser_reset(&parser, SNIPPETS[i]);
+				parse(&parser, SNIPPETS[i]);
+			}
+		}
+		report("reset", count, now_ms() - start, allocs - before);
+		parser_free(&parser);
+	}
+
+	return 0;
+}
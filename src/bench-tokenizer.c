@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "tokenizer/tokenizer.h"
+#include "tokenizer/lex_parallel.h"
+
+// identifier throughput: lexes a generated buffer of identifiers
+// and keywords and reports tokens/s and MB/s, then the same buffer
+// with tok_lex_parallel on 1..THREADS threads.
+//     bench-tokenizer [MB] [THREADS]
+
+static const char* const WORDS[] = {
+	"x", "foo", "bar_baz", "let", "func", "return", "if", "else",
+	"some_long_identifier", "another_identifier_name", "u32", "i64",
+	"struct", "continue", "restrict", "counter", "value", "for", "goto",
+	"result", "tmp", "index", "static", "len", "data"
+};
+
+static double now_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+	size_t size = (argc > 1 ? atol(argv[1]) : 64) << 20;
+	int max_threads = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+	char* src = malloc(size + 1);
+	if (src == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	size_t len = 0;
+	unsigned seed = 1;
+	for (;;) {
+		seed = seed * 1103515245 + 12345;
+		const char* word = WORDS[(seed >> 16) % (sizeof(WORDS) / sizeof(*WORDS))];
+		size_t word_len = strlen(word);
+		if (len + word_len + 1 > size) break;
+		memcpy(&src[len], word, word_len);
+		len += word_len;
+		src[len++] = (seed >> 8) % 8 == 0 ? '\n' : ' ';
+	}
+	src[len] = '\0';
+
+	for (int run = 0; run < 3; run++) {
+		Tokenizer tokenizer;
+		tok_init(&tokenizer, src);
+
+		size_t count = 0, keywords = 0;
+		double start = now_ms();
+		for (;;) {
+			Token tok = tok_next(&tokenizer);
+			if (tok.type == TOKEN_EOF) break;
+			if (tok.type != TOKEN_IDENT) keywords++;
+			count++;
+		}
+		double ms = now_ms() - start;
+		tok_free(&tokenizer);
+
+		printf("%zu tokens (%zu keywords) in %.1f ms: %.1f Mtok/s, %.0f MB/s\n",
+			count, keywords, ms, count / ms / 1e3, len / ms / 1e3);
+	}
+
+	double base_ms = 0;
+	for (int threads = 1; threads <= max_threads; threads++) {
+		TokenList list;
+		double start = now_ms();
+		if (!tok_lex_parallel(src, len, threads, NULL, NULL, &list)) {
+			fprintf(stderr, "out of memory\n");
+			return 1;
+		}
+		double ms = now_ms() - start;
+		if (threads == 1) base_ms = ms;
+
+		printf("parallel, %2d threads: %zu tokens in %.1f ms: %.0f MB/s (%.2fx)\n",
+			threads, list.len, ms, len / ms / 1e3, base_ms / ms);
+		token_list_free(&list);
+	}
+
+	free(src);
+	return 0;
+}
@@ -0,0 +1,54 @@
+// build-time generator for build/builtin_names.h.
+//
+// interns the names in parser/builtins.h, in order, into a StrPool and
+// prints its data, entries and hash slots as static tables, so each
+// parser's name pool can sit over them instead of interning the
+// builtins at startup.
+
+#include <stdio.h>
+#include "tokenizer/strpool.c"
+#include "parser/builtins.h"
+
+static const char* const NAMES[] = {
+	#define X(name, ref) #name,
+	BUILTIN_SYMBOLS(X, X)
+	#undef X
+};
+#define NAMES_LEN (sizeof(NAMES) / sizeof(*NAMES))
+
+int main() {
+	StrPool pool;
+	strpool_init(&pool);
+	for (size_t i = 0; i < NAMES_LEN; i++) {
+		if (strpool_intern(&pool, NAMES[i], strlen(NAMES[i])) != i) {
+			fprintf(stderr, "gen-builtins: duplicate name %s\n", NAMES[i]);
+			return 1;
+		}
+	}
+
+	printf("// generated by src/gen-builtins.c from src/parser/builtins.h; do not edit\n");
+	printf("#ifndef _BUILTIN_NAMES_H\n#define _BUILTIN_NAMES_H\n\n");
+	printf("#define BUILTIN_NAMES_LEN %zu\n", pool.len);
+	printf("#define BUILTIN_NAMES_DATA_LEN %zu\n", pool.data_len);
+	printf("#define BUILTIN_NAMES_SLOTS_CAP %zu\n\n", pool.slots_cap);
+
+	// one literal per name, so a name can't run into the previous escape
+	printf("static const char builtin_names_data[BUILTIN_NAMES_DATA_LEN + 1] =\n");
+	for (size_t i = 0; i < pool.len; i++) printf("\t\"%s\\0\"\n", strpool_get(&pool, i));
+	printf(";\n\n");
+
+	printf("static const struct StrPoolEntry builtin_names_entries[BUILTIN_NAMES_LEN] = {\n");
+	for (size_t i = 0; i < pool.len; i++) {
+		printf("\t{ .offset = %u, .len = %u, .hash = 0x%08xu },\n", pool.entries[i].offset, pool.entries[i].len, pool.entries[i].hash);
+	}
+	printf("};\n\n");
+
+	printf("static const uint32_t builtin_names_slots[BUILTIN_NAMES_SLOTS_CAP] = {\n");
+	for (size_t i = 0; i < pool.slots_cap; i++) {
+		if (pool.slots[i] != 0) printf("\t[%zu] = %u,\n", i, pool.slots[i]);
+	}
+	printf("};\n\n#endif\n");
+
+	strpool_free(&pool);
+	return 0;
+}
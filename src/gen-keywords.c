@@ -0,0 +1,87 @@
+// build-time generator for build/keyword_hash.h.
+//
+// finds multipliers A, B such that
+//     KEYWORD_HASH(len, first, last) = (first * A + last * B + len) & (KEYWORD_TABLE_LEN - 1)
+// is collision-free over the keyword list in tokenizer/keywords.h,
+// then prints the hash and the keywords[]/keyword_tokens[] tables
+// laid out by slot.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "tokenizer/keywords.h"
+
+typedef struct {
+	const char* text;
+	const char* token;
+} Keyword;
+
+static const Keyword KEYWORD_LIST[] = {
+	#define X(kwd, tok) { #kwd, #tok },
+	KEYWORDS(X)
+	#undef X
+};
+#define KEYWORD_COUNT (sizeof(KEYWORD_LIST) / sizeof(*KEYWORD_LIST))
+
+static unsigned hash(const char* s, unsigned a, unsigned b, unsigned size) {
+	size_t len = strlen(s);
+	return ((unsigned char)s[0] * a + (unsigned char)s[len - 1] * b + (unsigned)len) & (size - 1);
+}
+
+static int try_params(unsigned a, unsigned b, unsigned size, int slots[]) {
+	for (unsigned i = 0; i < size; i++) slots[i] = -1;
+	for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+		unsigned h = hash(KEYWORD_LIST[i].text, a, b, size);
+		if (slots[h] != -1) return 0;
+		slots[h] = (int)i;
+	}
+	return 1;
+}
+
+int main() {
+	int slots[256];
+	for (unsigned size = 32; size <= 256; size *= 2) {
+		if (size < KEYWORD_COUNT) continue;
+		for (unsigned a = 1; a < 256; a++) {
+			for (unsigned b = 0; b < 256; b++) {
+				if (!try_params(a, b, size, slots)) continue;
+
+				size_t min_len = SIZE_MAX, max_len = 0;
+				for (size_t i = 0; i < KEYWORD_COUNT; i++) {
+					size_t len = strlen(KEYWORD_LIST[i].text);
+					if (len < min_len) min_len = len;
+					if (len > max_len) max_len = len;
+				}
+
+				printf("// generated by src/gen-keywords.c from src/tokenizer/keywords.h; do not edit\n");
+				printf("#ifndef _KEYWORD_HASH_H\n#define _KEYWORD_HASH_H\n\n");
+				printf("#define KEYWORD_TABLE_LEN %u\n", size);
+				printf("#define KEYWORD_MIN_LEN %zu\n", min_len);
+				printf("#define KEYWORD_MAX_LEN %zu\n", max_len);
+				printf("#define KEYWORD_HASH(len, first, last) (((unsigned)(first) * %uu + (unsigned)(last) * %uu + (unsigned)(len)) & (KEYWORD_TABLE_LEN - 1))\n\n", a, b);
+
+				printf("static const char* const keywords[KEYWORD_TABLE_LEN] = {\n");
+				for (unsigned i = 0; i < size; i++) {
+					if (slots[i] != -1) printf("\t[%u] = \"%s\",\n", i, KEYWORD_LIST[slots[i]].text);
+				}
+				printf("};\n\n");
+
+				printf("static const unsigned char keyword_lens[KEYWORD_TABLE_LEN] = {\n");
+				for (unsigned i = 0; i < size; i++) {
+					if (slots[i] != -1) printf("\t[%u] = %zu,\n", i, strlen(KEYWORD_LIST[slots[i]].text));
+				}
+				printf("};\n\n");
+
+				printf("static const TokenType keyword_tokens[KEYWORD_TABLE_LEN] = {\n");
+				for (unsigned i = 0; i < size; i++) {
+					printf("\t[%u] = %s,\n", i, slots[i] != -1 ? KEYWORD_LIST[slots[i]].token : "TOKEN_IDENT");
+				}
+				printf("};\n\n#endif\n");
+				return 0;
+			}
+		}
+	}
+
+	fprintf(stderr, "gen-keywords: no collision-free hash found\n");
+	return 1;
+}
@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_ALIGN _Alignof(max_align_t)
+
+void arena_init(Arena* arena) {
+	arena->head = NULL;
+	arena->current = NULL;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	ArenaBlock* block = arena->current;
+	if (block != NULL && block->cap - block->used >= size) {
+		void* out = &block->data[block->used];
+		block->used += size;
+		return out;
+	}
+
+	// move on to the next block, if it's big enough, or put a new one before it
+	ArenaBlock* next = block != NULL ? block->next : arena->head;
+	if (next == NULL || next->cap < size) {
+		size_t cap = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+		ArenaBlock* fresh = malloc(sizeof(ArenaBlock) + cap);
+		if (fresh == NULL) return NULL;
+		fresh->cap = cap;
+		fresh->next = next;
+		if (block != NULL) block->next = fresh;
+		else arena->head = fresh;
+		next = fresh;
+	}
+
+	next->used = size;
+	arena->current = next;
+	return &next->data[0];
+}
+
+void arena_free(Arena* arena) {
+	ArenaBlock* block = arena->head;
+	while (block != NULL) {
+		ArenaBlock* next = block->next;
+		free(block);
+		block = next;
+	}
+	arena_init(arena);
+}
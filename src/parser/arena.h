@@ -0,0 +1,52 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <stddef.h>
+
+// bump allocator: memory comes from a chain of blocks and is only
+// given back all at once, by arena_rollback or arena_free.
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+typedef struct ArenaBlock {
+	struct ArenaBlock* next;
+	size_t cap;
+	size_t used;
+	_Alignas(max_align_t) char data[];
+} ArenaBlock;
+
+typedef struct {
+	ArenaBlock* head;
+	// block being allocated from; blocks after it are empty and
+	// reused before new ones are allocated
+	ArenaBlock* current;
+} Arena;
+
+typedef struct {
+	ArenaBlock* block;
+	size_t used;
+} ArenaMark;
+
+void arena_init(Arena* arena);
+// returns NULL if out of memory. aligned for any type.
+void* arena_alloc(Arena* arena, size_t size);
+void arena_free(Arena* arena);
+
+static inline ArenaMark arena_mark(const Arena* arena) {
+	return (ArenaMark){
+		.block = arena->current,
+		.used = arena->current != NULL ? arena->current->used : 0,
+	};
+}
+
+// frees everything allocated since the mark was taken, keeping the blocks
+static inline void arena_rollback(Arena* arena, ArenaMark mark) {
+	arena->current = mark.block;
+	if (mark.block != NULL) mark.block->used = mark.used;
+}
+
+// frees everything, keeping the blocks
+static inline void arena_reset(Arena* arena) {
+	arena_rollback(arena, (ArenaMark){ .block = NULL, .used = 0 });
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include <stdlib.h>
+#include "ast.h"
+#include "parser.h"
+#include "nodes/literal.h"
+#include "nodes/ident.h"
+#include "nodes/op_unary.h"
+#include "nodes/op_binary.h"
+#include "nodes/let.h"
+#include "nodes/func_call.h"
+#include "nodes/index.h"
+#include "nodes/field.h"
+
+void ast_init(Ast* ast) {
+	ast->tags = NULL;
+	ast->main_tokens = NULL;
+	ast->data = NULL;
+	ast->types = NULL;
+	ast->len = 0;
+	ast->cap = 0;
+	ast->extra = NULL;
+	ast->extra_len = 0;
+	ast->extra_cap = 0;
+}
+
+void ast_free(Ast* ast) {
+	free(ast->tags);
+	free(ast->main_tokens);
+	free(ast->data);
+	free(ast->types);
+	free(ast->extra);
+	ast_init(ast);
+}
+
+static bool ast_reserve(Ast* ast, size_t cap) {
+	if (cap <= ast->cap) return true;
+
+	#define GROW(field) do { \
+		void* p = realloc(ast->field, cap * sizeof(*ast->field)); \
+		if (p == NULL) return false; \
+		ast->field = p; \
+	} while (0)
+	GROW(tags);
+	GROW(main_tokens);
+	GROW(data);
+	GROW(types);
+	#undef GROW
+
+	ast->cap = cap;
+	return true;
+}
+
+// returns the index of n new u32s at the end of extra, or SIZE_MAX
+static size_t extra_alloc(Ast* ast, size_t n) {
+	if (ast->extra_len + n > ast->extra_cap) {
+		size_t cap = ast->extra_cap == 0 ? 64 : ast->extra_cap;
+		while (cap < ast->extra_len + n) cap *= 2;
+		uint32_t* extra = realloc(ast->extra, cap * sizeof(uint32_t));
+		if (extra == NULL) return SIZE_MAX;
+		ast->extra = extra;
+		ast->extra_cap = cap;
+	}
+	size_t index = ast->extra_len;
+	ast->extra_len += n;
+	return index;
+}
+
+// a unary op's operand is 64 bits; UINT64_MAX (no length) becomes AST_NONE
+static bool narrow(uint64_t data, uint32_t* out) {
+	if (data == UINT64_MAX) {
+		*out = AST_NONE;
+		return true;
+	}
+	if (data >= AST_NONE) return false;
+	*out = (uint32_t)data;
+	return true;
+}
+
+bool ast_build(Ast* ast, const Parser* parser) {
+	ast->len = 0;
+	ast->extra_len = 0;
+	if (!ast_reserve(ast, parser->nodes.len)) return false;
+
+	// children are always added before their parents, so one pass in
+	// order lowers everything and keeps the refs
+	for (size_t i = 0; i < parser->nodes.len; i++) {
+		Node* node = arrlist_get(&parser->nodes, i);
+
+		uint8_t tag;
+		uint32_t main_token, lhs = AST_NONE, rhs = AST_NONE;
+
+		switch (node->kind) {
+		case NODE_LITERAL: {
+			NodeLiteral* literal = (NodeLiteral*)node;
+			tag = AST_LITERAL;
+			main_token = literal->token;
+			break;
+		}
+		case NODE_IDENT: {
+			NodeIdent* ident = (NodeIdent*)node;
+			tag = AST_IDENT;
+			main_token = ident->first_token;
+			lhs = ident->name;
+			rhs = ident->last_token;
+			break;
+		}
+		case NODE_OP_UNARY: {
+			NodeOpUnary* op = (NodeOpUnary*)node;
+			tag = AST_OP_UNARY;
+			main_token = op->op;
+			lhs = op->child;
+			if (!narrow(op->data, &rhs)) return false;
+			break;
+		}
+		case NODE_OP_BINARY: {
+			NodeOpBinary* op = (NodeOpBinary*)node;
+			tag = AST_OP_BINARY;
+			main_token = op->op;
+			lhs = op->children[0];
+			rhs = op->children[1];
+			break;
+		}
+		case NODE_LET: {
+			NodeLet* let = (NodeLet*)node;
+			tag = AST_LET;
+			main_token = let->kwd;
+			lhs = let->type;
+
+			size_t index = extra_alloc(ast, sizeof(AstLet) / sizeof(uint32_t));
+			if (index >= AST_NONE) return false;
+			AstLet* out = (AstLet*)&ast->extra[index];
+			out->mut = let->mut;
+			out->linkage = let->linkage;
+			out->ident_start = let->ident_start;
+			out->ident_end = let->ident_end;
+			out->name = let->ident_name;
+			out->value = let->value;
+			rhs = index;
+			break;
+		}
+		case NODE_FUNC_CALL: {
+			NodeFuncCall* call = (NodeFuncCall*)node;
+			tag = AST_FUNC_CALL;
+			main_token = call->paren_left;
+
+			size_t index = extra_alloc(ast, sizeof(AstCall) / sizeof(uint32_t) + call->children_len);
+			if (index >= AST_NONE) return false;
+			AstCall* out = (AstCall*)&ast->extra[index];
+			out->paren_right = call->paren_right;
+			out->len = call->children_len;
+			for (size_t j = 0; j < call->children_len; j++) {
+				out->children[j] = call->children[j];
+			}
+			lhs = index;
+			break;
+		}
+		case NODE_INDEX: {
+			NodeIndex* index = (NodeIndex*)node;
+			main_token = index->bracket_left;
+			lhs = index->children[0];
+
+			if (index->colon == TOKREF_ERR) {
+				tag = AST_INDEX;
+				rhs = index->children[1];
+			} else {
+				tag = AST_SLICE;
+				size_t at = extra_alloc(ast, sizeof(AstSlice) / sizeof(uint32_t));
+				if (at >= AST_NONE) return false;
+				AstSlice* out = (AstSlice*)&ast->extra[at];
+				size_t child = 1;
+				out->start = (index->bounds & INDEX_START) ? index->children[child++] : AST_NONE;
+				out->end = (index->bounds & INDEX_END) ? index->children[child++] : AST_NONE;
+				rhs = at;
+			}
+			break;
+		}
+		case NODE_FIELD: {
+			NodeField* field = (NodeField*)node;
+			tag = AST_FIELD;
+			main_token = field->dot;
+			lhs = field->child;
+			rhs = field->name;
+			break;
+		}
+		default:
+			return false;
+		}
+
+		ast->tags[i] = tag;
+		ast->main_tokens[i] = main_token;
+		ast->data[i] = (AstData){lhs, rhs};
+		ast->types[i] = parser_nodetype(parser, i);
+		ast->len++;
+	}
+
+	return true;
+}
@@ -0,0 +1,143 @@
+#ifndef _AST_H
+#define _AST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "parser_forward.h"
+
+// flat AST: each node is a tag, a main token, and two operands, stored
+// in parallel arrays so a walk touches a few dense arrays instead of
+// one heap object per node. children that don't fit in the
+// operands live in the shared `extra` array.
+//
+// built from a parser's nodes by ast_build; an AstRef is the NodeRef of
+// the node it was lowered from, and the parser's 32-bit sentinels
+// (NODE_ERR, TOKREF_ERR, TYPEREF_ERR) all read as AST_NONE.
+
+typedef NodeRef AstRef;
+#define AST_NONE UINT32_MAX
+
+typedef enum {
+	// lhs, rhs unused
+	AST_LITERAL,
+	// lhs = SymbolId of the name, rhs = its last token (after any ::)
+	AST_IDENT,
+	// lhs = operand, rhs = array length, or TYPE_MUT
+	AST_OP_UNARY,
+	// lhs, rhs = operands
+	AST_OP_BINARY,
+	// main_token = let/const/static; lhs = type or AST_NONE,
+	// rhs = index of an AstLet in extra
+	AST_LET,
+	// main_token = '('; lhs = index of an AstCall in extra
+	AST_FUNC_CALL,
+	// main_token = '['; lhs = operand, rhs = index
+	AST_INDEX,
+	// main_token = '['; lhs = operand, rhs = index of an AstSlice in extra
+	AST_SLICE,
+	// main_token = '.'; lhs = operand, rhs = SymbolId of the field
+	AST_FIELD,
+} AstTag;
+
+typedef struct {
+	uint32_t lhs;
+	uint32_t rhs;
+} AstData;
+
+// laid out as consecutive u32s in extra
+typedef struct {
+	uint32_t mut; // AST_NONE if absent
+	uint32_t linkage; // AST_NONE if absent
+	uint32_t ident_start;
+	uint32_t ident_end;
+	uint32_t name;
+	uint32_t value; // AST_NONE if absent
+} AstLet;
+
+typedef struct {
+	AstRef start; // AST_NONE if absent
+	AstRef end; // AST_NONE if absent
+} AstSlice;
+
+typedef struct {
+	uint32_t paren_right;
+	uint32_t len;
+	AstRef children[]; // the function, then its arguments
+} AstCall;
+
+typedef struct {
+	uint8_t* tags;
+	uint32_t* main_tokens;
+	AstData* data;
+	// TypeRef of each expression; AST_NONE for statements
+	uint32_t* types;
+	size_t len;
+	size_t cap;
+
+	uint32_t* extra;
+	size_t extra_len;
+	size_t extra_cap;
+} Ast;
+
+void ast_init(Ast* ast);
+void ast_free(Ast* ast);
+// lowers every node the parser has made. returns false if out of
+// memory, or if an array length doesn't fit in 32 bits.
+bool ast_build(Ast* ast, const Parser* parser);
+
+static inline const AstLet* ast_let(const Ast* ast, AstRef node) {
+	return (const AstLet*)&ast->extra[ast->data[node].rhs];
+}
+
+static inline const AstCall* ast_call(const Ast* ast, AstRef node) {
+	return (const AstCall*)&ast->extra[ast->data[node].lhs];
+}
+
+static inline const AstSlice* ast_slice(const Ast* ast, AstRef node) {
+	return (const AstSlice*)&ast->extra[ast->data[node].rhs];
+}
+
+// children of node in source order, without the absent ones. points
+// into extra, or into buf (which must hold 3) for the others.
+static inline size_t ast_children(const Ast* ast, AstRef node, AstRef buf[3], const AstRef** out) {
+	AstData data = ast->data[node];
+	*out = buf;
+	switch ((AstTag)ast->tags[node]) {
+	case AST_LITERAL:
+	case AST_IDENT:
+		return 0;
+	case AST_OP_UNARY:
+	case AST_FIELD:
+		buf[0] = data.lhs;
+		return 1;
+	case AST_OP_BINARY:
+	case AST_INDEX:
+		buf[0] = data.lhs;
+		buf[1] = data.rhs;
+		return 2;
+	case AST_LET: {
+		size_t len = 0;
+		if (data.lhs != AST_NONE) buf[len++] = data.lhs;
+		uint32_t value = ast_let(ast, node)->value;
+		if (value != AST_NONE) buf[len++] = value;
+		return len;
+	}
+	case AST_FUNC_CALL: {
+		const AstCall* call = ast_call(ast, node);
+		*out = call->children;
+		return call->len;
+	}
+	case AST_SLICE: {
+		const AstSlice* slice = ast_slice(ast, node);
+		size_t len = 0;
+		buf[len++] = data.lhs;
+		if (slice->start != AST_NONE) buf[len++] = slice->start;
+		if (slice->end != AST_NONE) buf[len++] = slice->end;
+		return len;
+	}
+	}
+	return 0;
+}
+
+#endif
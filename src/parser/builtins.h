@@ -0,0 +1,32 @@
+#ifndef _BUILTINS_H
+#define _BUILTINS_H
+
+// the single list of builtin symbols. their names have fixed ids, in this
+// order, in every parser's name pool; src/gen-builtins.c interns them
+// ahead of time into build/builtin_names.h.
+//
+// TYPE(name, TYPEREF_*) for types, VALUE(name, TYPEREF_*) for values
+#define BUILTIN_SYMBOLS(TYPE, VALUE) \
+	TYPE(i8, TYPEREF_I8) \
+	TYPE(i16, TYPEREF_I16) \
+	TYPE(i32, TYPEREF_I32) \
+	TYPE(i64, TYPEREF_I64) \
+	TYPE(isize, TYPEREF_ISIZE) \
+	TYPE(u8, TYPEREF_U8) \
+	TYPE(u16, TYPEREF_U16) \
+	TYPE(u32, TYPEREF_U32) \
+	TYPE(u64, TYPEREF_U64) \
+	TYPE(usize, TYPEREF_USIZE) \
+	TYPE(f16, TYPEREF_F16) \
+	TYPE(f32, TYPEREF_F32) \
+	TYPE(f64, TYPEREF_F64) \
+	TYPE(f64x, TYPEREF_F64X) \
+	TYPE(type, TYPEREF_TYPE) \
+	TYPE(void, TYPEREF_VOID) \
+	TYPE(bool, TYPEREF_BOOL) \
+\
+	VALUE(true, TYPEREF_BOOL) \
+	VALUE(false, TYPEREF_BOOL) \
+	VALUE(null, TYPEREF_VOID)
+
+#endif
@@ -6,19 +6,98 @@
 #include "parser_forward.h"
 #include "types.h"
 
-#define NODE_ERR SIZE_MAX
+#define NODE_ERR UINT32_MAX
 
-typedef struct Node Node;
+// the single list of node kinds. for X(KIND, prefix, Struct, "Name"),
+// nodes/prefix.c must define
+//     TypeRef node_prefix_type(const Parser*, Struct*); // TYPEREF_ERR for statements
+//     NodeRefSlice node_prefix_children(const Parser*, Struct*);
+//     TokenRef node_prefix_token(const Parser*, Struct*);
+// which node_type, node_children and node_token below dispatch to with a
+// switch, so a kind missing a hook fails to build.
+#define NODE_KINDS(X) \
+	X(LITERAL, literal, NodeLiteral, "Literal") \
+	X(IDENT, ident, NodeIdent, "Ident") \
+	X(OP_UNARY, op_unary, NodeOpUnary, "OpUnary") \
+	X(OP_BINARY, op_binary, NodeOpBinary, "OpBinary") \
+	X(LET, let, NodeLet, "Let") \
+	X(FUNC_CALL, func_call, NodeFuncCall, "NodeFuncCall") \
+	X(INDEX, index, NodeIndex, "Index") \
+	X(FIELD, field, NodeField, "Field")
 
-typedef struct NodeVTable {
-	const char* name;
-	TypeRef (*type)( const Parser*, Node*);
-	NodeRefSlice (*children)( const Parser*, Node*);
-	TokenRef (*token)( const Parser*, Node*);
-} NodeVTable;
+typedef enum {
+	#define X(kind, prefix, Struct, name) NODE_##kind,
+	NODE_KINDS(X)
+	#undef X
+} NodeKind;
 
-struct Node {
-	NodeVTable* vtable;
-};
+// every node struct starts with its kind
+typedef struct Node {
+	NodeKind kind;
+} Node;
 
-#endif
\ No newline at end of file
+#define X(kind, prefix, Struct, name) \
+	typedef struct Struct Struct; \
+	TypeRef node_##prefix##_type(const Parser* parser, Struct* node); \
+	NodeRefSlice node_##prefix##_children(const Parser* parser, Struct* node); \
+	TokenRef node_##prefix##_token(const Parser* parser, Struct* node);
+NODE_KINDS(X)
+#undef X
+
+static inline const char* node_name(const Node* node) {
+	switch (node->kind) {
+	#define X(kind, prefix, Struct, name) case NODE_##kind: return name;
+	NODE_KINDS(X)
+	#undef X
+	}
+	__builtin_unreachable();
+}
+
+// the node's type, computed from scratch; see parser_nodetype for the cached one
+static inline TypeRef node_type(const Parser* parser, Node* node) {
+	switch (node->kind) {
+	#define X(kind, prefix, Struct, name) case NODE_##kind: return node_##prefix##_type(parser, (Struct*)node);
+	NODE_KINDS(X)
+	#undef X
+	}
+	__builtin_unreachable();
+}
+
+static inline NodeRefSlice node_children(const Parser* parser, Node* node) {
+	switch (node->kind) {
+	#define X(kind, prefix, Struct, name) case NODE_##kind: return node_##prefix##_children(parser, (Struct*)node);
+	NODE_KINDS(X)
+	#undef X
+	}
+	__builtin_unreachable();
+}
+
+static inline TokenRef node_token(const Parser* parser, Node* node) {
+	switch (node->kind) {
+	#define X(kind, prefix, Struct, name) case NODE_##kind: return node_##prefix##_token(parser, (Struct*)node);
+	NODE_KINDS(X)
+	#undef X
+	}
+	__builtin_unreachable();
+}
+
+// one callback per kind, called before a node's children; returning
+// false skips them. a NULL callback just descends. see node_visit; it
+// walks with node_walk_next, which skips absent (NODE_ERR) children.
+typedef struct {
+	#define X(kind, prefix, Struct, name) bool (*prefix)(void* ctx, const Parser* parser, NodeRef ref, Struct* node);
+	NODE_KINDS(X)
+	#undef X
+} NodeVisitor;
+
+static inline bool node_visitor_call(const NodeVisitor* visitor, void* ctx, const Parser* parser, NodeRef ref, Node* node) {
+	switch (node->kind) {
+	#define X(kind, prefix, Struct, name) case NODE_##kind: \
+		return visitor->prefix == NULL || visitor->prefix(ctx, parser, ref, (Struct*)node);
+	NODE_KINDS(X)
+	#undef X
+	}
+	__builtin_unreachable();
+}
+
+#endif
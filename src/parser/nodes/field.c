@@ -0,0 +1,53 @@
+#include "field.h"
+
+TypeRef node_field_type(const Parser* parser, NodeField* node) {
+    return node->type;
+}
+
+TokenRef node_field_token(const Parser* parser, NodeField* node) {
+    return node->dot;
+}
+
+NodeRefSlice node_field_children(const Parser* parser, NodeField* node) {
+    return (NodeRefSlice){
+        .len = 1,
+        .data = &node->child
+    };
+}
+
+NodeRef node_field_parse(Parser* parser, NodeRef operand) {
+    TokenRef dot = parser_consume(parser);
+
+    TokenRef name_token;
+    if (!parser_consume_if(parser, TOKEN_IDENT, &name_token)) RET_ERROR(parser, "expected field name");
+    SymbolId name = parser_gettokval(parser, name_token)->str;
+
+    TypeRef operand_typeref = parser_nodetype(parser, operand);
+    if (operand_typeref == TYPEREF_ERR) RET_ERROR(parser, "expected expression, found statement in field access");
+    Type operand_type = typetable_get(&parser->types, operand_typeref)->type;
+    if (operand_type.tag != TYPE_STRUCT && operand_type.tag != TYPE_UNION) {
+        RET_ERROR(parser, "only structs and unions have fields");
+    }
+
+    TypeFields* fields = UINT_TO_PTR(operand_type.data);
+    const char* name_str = strpool_get(&parser->names, name);
+    TypeRef type = TYPEREF_ERR;
+    for (size_t i = 0; i < fields->fields.len; i++) {
+        TypeFieldsField* field = arrlist_get(&fields->fields, i);
+        if (strcmp(field->name, name_str) == 0) {
+            type = field->type;
+            break;
+        }
+    }
+    if (type == TYPEREF_ERR) RET_ERROR(parser, "no such field");
+
+    NodeField* out = parser_allocnode(parser, sizeof(NodeField));
+    RET_IF_OOM(parser, out);
+    out->kind = NODE_FIELD;
+    out->dot = dot;
+    out->name_token = name_token;
+    out->name = name;
+    out->type = type;
+    out->child = operand;
+    return parser_addnode(parser, (Node*)out);
+}
@@ -0,0 +1,19 @@
+#ifndef _FIELD_H
+#define _FIELD_H
+
+#include "../parser.h"
+
+// a.name, on a struct or union
+typedef struct NodeField {
+    NodeKind kind;
+    TokenRef dot;
+    TokenRef name_token;
+    SymbolId name;
+    TypeRef type;
+    NodeRef child;
+} NodeField;
+
+// the current token must be the '.' after operand
+NodeRef node_field_parse(Parser* parser, NodeRef operand);
+
+#endif
@@ -1,17 +1,13 @@
 #include "func_call.h"
 #include "../types.h"
-#include "grouping.h"
 #include "op_binary.h"
 #include <assert.h>
 
 TypeRef node_func_call_type(const Parser* parser, NodeFuncCall* node) {
-    Node* n = arrlist_get(&parser->nodes, node->children[0]);
+    TypeRef func_typeref = parser_nodetype(parser, node->children[0]);
+    assert(func_typeref != TYPEREF_ERR);
 
-    assert(n != NULL);
-    assert(n->vtable->type != NULL);
-
-    TypeRef func_typeref = n->vtable->type(parser, n);
-    TypeEntry* func_type = typetable_get(&parser->types, func_typeref);
+    const TypeEntry* func_type = typetable_get(&parser->types, func_typeref);
 
     assert (func_type->type.tag == TYPE_FUNC);
 
@@ -30,84 +26,68 @@ NodeRefSlice node_func_call_children(const Parser* parser, NodeFuncCall* node) {
     };
 }
 
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_FUNC_CALL = {
-    .children = node_func_call_children,
-    .token = node_func_call_token,
-    .type = node_func_call_type,
-    .name = "NodeFuncCall"
-};
-#pragma GCC diagnostic pop
-
-
 #define CHECK(type_) (parser_getpeek(parser)->type == (type_))
-NodeRef node_func_call_parse(Parser* parser) {
-    NodeRef func = node_grouping_parse(parser);
-    RET_IF_ERR(parser, func);
-
-	if (!CHECK(TOKEN_PAREN_LEFT)) {
-		return func;
-	}
-
+// errors once arguments may be pending drop them, so a caller that
+// carries on without a rollback doesn't find them in its own call
+#define RET_ERROR_PENDING(err) do { \
+		parser->pending_len = base; \
+		RET_ERROR(parser, err); \
+	} while (0)
+
+NodeRef node_func_call_parse(Parser* parser, NodeRef func) {
 	TokenRef left_ref = parser_consume(parser);
 
-    Node* func_node = arrlist_get(&parser->nodes, func);
-	TypeRef func_typeref = func_node->vtable->type(parser, func_node);
-    TypeEntry* func_type = typetable_get(&parser->types, func_typeref);
-
-	if (func_type->type.tag != TYPE_FUNC) {
+	TypeRef func_typeref = parser_nodetype(parser, func);
+	if (func_typeref == TYPEREF_ERR || typetable_get(&parser->types, func_typeref)->type.tag != TYPE_FUNC) {
 		RET_ERROR(parser, "lhs of function call is not a function");
 	}
 
-	TypeFuncData* func_data = (void*)func_type->type.data;
-
-	NodeFuncCall* call = malloc(sizeof(NodeFuncCall) + 2 * sizeof(NodeRef));
-	RET_IF_OOM(parser, call);
-    call->vtable = &NODE_IMPL_FUNC_CALL;
-    call->paren_left = left_ref;
-    call->children[0] = func;
-    call->children_len = 1;
-
-	if (CHECK(TOKEN_PAREN_RIGHT)) {
-		if (func_data->arg_types.len != 0) {
-			RET_ERROR(parser, "function call has wrong # of args");
-		}
-
-		call->paren_right = parser_consume(parser);
-        return arrlist_add(&parser->nodes, call);
-	}
-
-	size_t cap = 1;
-	for (;;) {
-		NodeRef arg = node_op_binary_parse(parser);
-		RET_IF_ERR(parser, arg);
-
-        Node* arg_node = arrlist_get(&parser->nodes, arg);
-        TypeRef arg_typeref = arg_node->vtable->type(parser, arg_node);
-
-		if (func_data->arg_types.len <= call->children_len - 1) {
-			if (!func_data->varardic) {
-				RET_ERROR(parser, "function call has too many arguments");
+	TypeFuncData* func_data = (void*)typetable_get(&parser->types, func_typeref)->type.data;
+
+	// the arguments are collected on the pending stack first, since
+	// nested calls allocate in the arena while they're being parsed
+	size_t base = parser->pending_len;
+	TokenRef right_ref;
+	if (!parser_consume_if(parser, TOKEN_PAREN_RIGHT, &right_ref)) {
+		for (;;) {
+			NodeRef arg = node_op_binary_parse_prec(parser, PREC_OR);
+			if (arg == NODE_ERR) {
+				parser->pending_len = base;
+				return NODE_ERR;
 			}
-		} else {
-			if (!type_can_coerce(&parser->types, arg_typeref, (TypeRef)arrlist_get(&func_data->arg_types, call->children_len - 1))) {
-				RET_ERROR(parser, "argument has incompatible type");
+
+			TypeRef arg_typeref = parser_nodetype(parser, arg);
+
+			size_t index = parser->pending_len - base;
+			if (func_data->arg_types.len <= index) {
+				if (!func_data->varardic) {
+					RET_ERROR_PENDING("function call has too many arguments");
+				}
+			} else {
+				if (!type_can_coerce(&parser->types, arg_typeref, PTR_TO_UINT(TypeRef, arrlist_get(&func_data->arg_types, index)))) {
+					RET_ERROR_PENDING("argument has incompatible type");
+				}
 			}
-		}
 
-		if (cap < call->children_len + 1) {
-			cap *= 2;
-			call = realloc(call, sizeof(NodeFuncCall) + sizeof(NodeRef) * cap);
-            RET_IF_OOM(parser, call);
-		}
+			if (!parser_pending_push(parser, arg)) RET_ERROR_PENDING("out of memory");
 
-        call->children[call->children_len] = arg;
-        call->children_len += 1;
+			if (parser_consume_if(parser, TOKEN_PAREN_RIGHT, &right_ref)) break;
+			if (!CHECK(TOKEN_COMMA)) RET_ERROR_PENDING("expected , or ) in function call");
+			parser_consume(parser);
+		}
 	}
 
-	if (func_data->arg_types.len > call->children_len - 1) RET_ERROR(parser, "function call has too few arguments");
+	size_t args_len = parser->pending_len - base;
+	if (func_data->arg_types.len > args_len) RET_ERROR_PENDING("function call has too few arguments");
+
+	NodeFuncCall* call = parser_allocnode(parser, sizeof(NodeFuncCall) + (1 + args_len) * sizeof(NodeRef));
+	if (call == NULL) RET_ERROR_PENDING("out of memory");
+    call->kind = NODE_FUNC_CALL;
+    call->paren_left = left_ref;
+    call->paren_right = right_ref;
+    call->children[0] = func;
+    call->children_len = 1 + args_len;
+    parser_pending_take(parser, base, &call->children[1]);
 
-    return arrlist_add(&parser->nodes, call);
-}
\ No newline at end of file
+    return parser_addnode(parser, (Node*)call);
+}
@@ -3,22 +3,17 @@
 
 #include "../parser.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeFuncCall {
+    NodeKind kind;
 
     TokenRef paren_left;
     TokenRef paren_right;
 
-    size_t children_len;
+    uint32_t children_len;
     NodeRef children[];
 } NodeFuncCall;
 
-TypeRef node_func_call_type(const Parser* parser, NodeFuncCall* node);
-TokenRef node_func_call_token(const Parser* parser, NodeFuncCall* node);
-NodeRefSlice node_func_call_children(const Parser* parser, NodeFuncCall* node);
-
-extern NodeVTable NODE_IMPL_FUNC_CALL;
-
-NodeRef node_func_call_parse(Parser* parser);
+// the current token must be the '(' after func
+NodeRef node_func_call_parse(Parser* parser, NodeRef func);
 
 #endif
\ No newline at end of file
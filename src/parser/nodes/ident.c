@@ -1,99 +1,85 @@
 #include "ident.h"
-#include <assert.h>
 
 TypeRef node_ident_type(const Parser* parser, NodeIdent* ident) {
-    SymbolEntry* entry = symbols_get(&parser->scopes[ident->scope], ident->name);
-    assert (entry != NULL);
-    return entry->type;
+    return ident->type;
 }
 
 TokenRef node_ident_token(const Parser* parser, NodeIdent* ident) {
     return ident->first_token;
 }
 
-char* ident_parse(Parser* parser, TokenRef* start, TokenRef* end) {
+NodeRefSlice node_ident_children(const Parser* parser, NodeIdent* ident) {
+    return (NodeRefSlice){.len = 0, .data = NULL};
+}
+
+// appends to the parser's scratch buffer at *len
+static bool ident_append(Parser* parser, size_t* len, const char* str, size_t str_len) {
+    if (*len + str_len > parser->scratch_cap) {
+        size_t cap = parser->scratch_cap == 0 ? 64 : parser->scratch_cap;
+        while (cap < *len + str_len) cap *= 2;
+        char* scratch = realloc(parser->scratch, cap);
+        if (scratch == NULL) return false;
+        parser->scratch = scratch;
+        parser->scratch_cap = cap;
+    }
+    memcpy(&parser->scratch[*len], str, str_len);
+    *len += str_len;
+    return true;
+}
+
+SymbolId ident_parse(Parser* parser, TokenRef* start, TokenRef* end) {
     TokenRef tokref;
     if(!parser_consume_if(parser, TOKEN_IDENT, &tokref)) {
         PARSER_ERR(parser,"expected identifier");
-        return NULL;
+        return SYMBOL_NONE;
     }
     *start = tokref;
-    Token* token = parser_gettok(parser, tokref);
+    *end = tokref;
+
+    // the tokenizer already interned each part
+    SymbolId name = parser_gettokval(parser, tokref)->str;
+    if (!parser_peek_is(parser, TOKEN_COLONS)) return name;
 
-	char* str = malloc(token->len+1);
-    if (str == NULL) {
+    // qualified names are joined in scratch and interned whole
+    size_t len = 0;
+    if (!ident_append(parser, &len, strpool_get(&parser->names, name), strpool_len(&parser->names, name))) {
         PARSER_ERR(parser, "out of memory");
-        return NULL;
+        return SYMBOL_NONE;
     }
 
-	size_t len = 0;
-	memcpy(&str[len], token->start, token->len);
-	len += token->len;
-
     TokenRef lastref = tokref;
-	for (;;) {
-		if (parser_peek_is(parser, TOKEN_COLONS)) {
-			parser_consume(parser);
-
-			str = realloc(str, len+2);			
-            if (str == NULL) {
-                PARSER_ERR(parser, "out of memory");
-                return NULL;
-            }
-	
-			memcpy(&str[len], "::", 2);
-			len += 2;
-		} else { break; }
+    while (parser_peek_is(parser, TOKEN_COLONS)) {
+        parser_consume(parser);
 
         if (!parser_consume_if(parser, TOKEN_IDENT, &lastref)) {
             PARSER_ERR(parser,"expected identifier");
-            return NULL;
+            return SYMBOL_NONE;
         }
-        Token* ident = parser_gettok(parser, lastref);
+        SymbolId part = parser_gettokval(parser, lastref)->str;
 
-		str = realloc(str, len + ident->len + 1);
-        if (str == NULL) {
+        if (!ident_append(parser, &len, "::", 2) ||
+                !ident_append(parser, &len, strpool_get(&parser->names, part), strpool_len(&parser->names, part))) {
             PARSER_ERR(parser, "out of memory");
-            return NULL;
+            return SYMBOL_NONE;
         }
-
-		memcpy(&str[len], ident->start, ident->len);
-		len += ident->len;
-	}
+    }
 
     *end = lastref;
-
-	str[len] = '\0';
-    return str;
+    return strpool_intern(&parser->names, parser->scratch, len);
 }
 
 NodeRef node_ident_parse(Parser* parser) {
-    NodeIdent* out = malloc(sizeof(NodeIdent));
+    NodeIdent* out = parser_allocnode(parser, sizeof(NodeIdent));
     RET_IF_OOM(parser,out);
-    out->vtable = &NODE_IMPL_IDENT;
-    char* str = ident_parse(parser, &out->first_token, &out->last_token);
-    out->name = str;
+    out->kind = NODE_IDENT;
+    out->name = ident_parse(parser, &out->first_token, &out->last_token);
+    if (out->name == SYMBOL_NONE) return NODE_ERR;
 
-    for (int i = parser->current_scope; i >= 0; i--) {
-        SymbolEntry* entry = symbols_get(&parser->scopes[i], out->name);
-        if (entry != NULL) {
-            out->scope = i;
-            goto found_scope;
-        }
-    }
-
-    RET_ERROR(parser, "identifier not found");
+    // the binding is gone once its scope closes, so keep what's needed of it
+    const SymbolEntry* entry = symbols_get(&parser->symbols, out->name);
+    if (entry == NULL) RET_ERROR(parser, "identifier not found");
+    out->type = entry->type;
+    out->mut = entry->mut;
 
-found_scope:
     return parser_addnode(parser, (Node*)out);
 }
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_IDENT = {
-    .name = "Ident",
-    .token = node_ident_token,
-    .type = node_ident_type,
-    .children = NULL
-}; 
-#pragma GCC diagnostic pop
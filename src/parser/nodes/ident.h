@@ -3,20 +3,17 @@
 
 #include "../parser.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeIdent {
+    NodeKind kind;
     TokenRef first_token;
     TokenRef last_token;
-    size_t scope;
-    char* name;
+    TypeRef type; // of its binding when it was parsed
+    bool mut; // whether that binding can be assigned to
+    SymbolId name;
 } NodeIdent;
 
-TypeRef node_ident_type(const Parser* parser, NodeIdent* ident);
-TokenRef node_ident_token(const Parser* parser, NodeIdent* ident);
-
-extern NodeVTable NODE_IMPL_IDENT;
-
-char* ident_parse(Parser* parser, TokenRef* start, TokenRef* end);
+// parses IDENT (:: IDENT)*; returns SYMBOL_NONE on error
+SymbolId ident_parse(Parser* parser, TokenRef* start, TokenRef* end);
 NodeRef node_ident_parse(Parser* parser);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "index.h"
+#include "op_binary.h"
+
+#define CHECK(type_) (parser_getpeek(parser)->type == (type_))
+
+TypeRef node_index_type(const Parser* parser, NodeIndex* node) {
+    return node->type;
+}
+
+TokenRef node_index_token(const Parser* parser, NodeIndex* node) {
+    return node->bracket_left;
+}
+
+NodeRefSlice node_index_children(const Parser* parser, NodeIndex* node) {
+    return (NodeRefSlice){
+        .len = node->children_len,
+        .data = node->children
+    };
+}
+
+// parses an index or bound and adds it to out's children
+static bool parse_bound(Parser* parser, NodeIndex* out) {
+    NodeRef bound = node_op_binary_parse_prec(parser, PREC_OR);
+    if (bound == NODE_ERR) return false;
+
+    TypeRef typeref = parser_nodetype(parser, bound);
+    TypeTag tag = typeref == TYPEREF_ERR ? TYPE_VOID : typetable_get(&parser->types, typeref)->type.tag;
+    if (tag != TYPE_INT && tag != TYPE_UINT) {
+        PARSER_ERR(parser, "index must be an integer");
+        return false;
+    }
+
+    out->children[out->children_len++] = bound;
+    return true;
+}
+
+NodeRef node_index_parse(Parser* parser, NodeRef operand) {
+    TypeRef operand_typeref = parser_nodetype(parser, operand);
+    if (operand_typeref == TYPEREF_ERR) RET_ERROR(parser, "expected expression, found statement in index");
+    Type operand_type = typetable_get(&parser->types, operand_typeref)->type;
+    if (operand_type.tag != TYPE_ARRAY && operand_type.tag != TYPE_SLICE && operand_type.tag != TYPE_PTR) {
+        RET_ERROR(parser, "only arrays, slices and pointers can be indexed");
+    }
+
+    NodeIndex* out = parser_allocnode(parser, sizeof(NodeIndex));
+    RET_IF_OOM(parser, out);
+    out->kind = NODE_INDEX;
+    out->bracket_left = parser_consume(parser);
+    out->colon = TOKREF_ERR;
+    out->bounds = 0;
+    out->children[0] = operand;
+    out->children_len = 1;
+
+    if (!CHECK(TOKEN_COLON)) {
+        if (!parse_bound(parser, out)) return NODE_ERR;
+        out->bounds |= INDEX_START;
+    }
+
+    if (CHECK(TOKEN_COLON)) {
+        out->colon = parser_consume(parser);
+        if (!CHECK(TOKEN_BRACKET_RIGHT)) {
+            if (!parse_bound(parser, out)) return NODE_ERR;
+            out->bounds |= INDEX_END;
+        }
+    }
+
+    if (!CHECK(TOKEN_BRACKET_RIGHT)) RET_ERROR(parser, "expected ]");
+    parser_consume(parser);
+
+    if (out->colon == TOKREF_ERR) {
+        out->bounds = 0;
+        out->type = operand_type.child;
+    } else {
+        // arrays are values, so only a slice or pointer passes on its mutability
+        Type slice = {
+            .tag = TYPE_SLICE,
+            .child = operand_type.child,
+            .data = operand_type.tag == TYPE_ARRAY ? 0 : operand_type.data & TYPE_MUT
+        };
+        out->type = typetable_add(&parser->types, "", slice);
+        if (out->type == TYPEREF_ERR) RET_ERROR(parser, "too many types");
+    }
+
+    return parser_addnode(parser, (Node*)out);
+}
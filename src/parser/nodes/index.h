@@ -0,0 +1,23 @@
+#ifndef _INDEX_H
+#define _INDEX_H
+
+#include "../parser.h"
+
+#define INDEX_START 0x1
+#define INDEX_END 0x2
+
+// a[i], or the slice a[start:end] where either bound may be left out
+typedef struct NodeIndex {
+    NodeKind kind;
+    TokenRef bracket_left;
+    TokenRef colon; // TOKREF_ERR if this is an index rather than a slice
+    TypeRef type;
+    uint8_t bounds; // INDEX_START | INDEX_END, for slices
+    uint32_t children_len;
+    NodeRef children[3]; // the operand, then the index or the bounds that are present
+} NodeIndex;
+
+// the current token must be the '[' after operand
+NodeRef node_index_parse(Parser* parser, NodeRef operand);
+
+#endif
@@ -2,6 +2,11 @@
 #include "ident.h"
 #include "op_binary.h"
 
+// a statement, not an expression
+TypeRef node_let_type(const Parser* parser, NodeLet* node) {
+    return TYPEREF_ERR;
+}
+
 TokenRef node_let_token(const Parser* parser, NodeLet* node) {
     return node->kwd;
 }
@@ -10,15 +15,6 @@ NodeRefSlice node_let_children(const Parser* parser, NodeLet* let)  {
     return (NodeRefSlice){.data = &let->type, .len=2};
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_LET = {
-    .name = "Let",
-    .token = node_let_token,
-    .children = node_let_children
-};
-#pragma GCC diagnostic pop
-
 // the current token must be the `let`, `static`, or `const` keyword; visiblity modifiers are passed in
 // syntax: let [mut] IDENT [TYPE] [= VALUE];
 // syntax: let [mut] [IDENT ,*] [TYPE]; (wip)
@@ -37,23 +33,24 @@ NodeRef node_let_parse(Parser* parser, TokenRef visibility) {
 
     // TODO: add multiple declarations
     TokenRef ident_start, ident_end;
-    char* name = ident_parse(parser, &ident_start, &ident_end);
-    if (name == NULL) {
+    SymbolId name = ident_parse(parser, &ident_start, &ident_end);
+    if (name == SYMBOL_NONE) {
         RET_ERROR(parser, "could not parse name");
     }
 
     NodeRef type = NODE_ERR;
     TokenRef eq = TOKREF_ERR;
     NodeRef value = NODE_ERR;
+    // both are parsed above assignment, so the `=` isn't taken as one
     if (!parser_peek_is(parser, TOKEN_EQ)) {
         // type
-        type = node_op_binary_parse(parser);
+        type = node_op_binary_parse_prec(parser, PREC_OR);
         RET_IF_ERR(parser, type);
     } 
 
     if (parser_peek_is(parser, TOKEN_EQ)) {
         eq = parser_consume(parser);
-        value = node_op_binary_parse(parser);
+        value = node_op_binary_parse_prec(parser, PREC_OR);
         RET_IF_ERR(parser, value);
     }
 
@@ -66,10 +63,10 @@ NodeRef node_let_parse(Parser* parser, TokenRef visibility) {
     }
     parser_consume(parser); // semicolon
 
-    NodeLet* node = malloc(sizeof(NodeLet));
+    NodeLet* node = parser_allocnode(parser, sizeof(NodeLet));
     RET_IF_OOM(parser, node);
 
-    node->vtable = &NODE_IMPL_LET;
+    node->kind = NODE_LET;
     node->kwd = kwd;
     node->mut = mut;
     node->linkage = visibility;
@@ -78,5 +75,5 @@ NodeRef node_let_parse(Parser* parser, TokenRef visibility) {
     node->ident_name = name;
     node->type = type;
     node->value = value;
-    return parser_addnode(parser, node);
-}
\ No newline at end of file
+    return parser_addnode(parser, (Node*)node);
+}
@@ -4,8 +4,8 @@
 #include "../parser.h"
 #include "../../tokenizer/tokenizer.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeLet {
+    NodeKind kind;
 
     TokenRef kwd;
 
@@ -14,17 +14,12 @@ typedef struct {
 
     TokenRef ident_start;
     TokenRef ident_end;
-    const char* ident_name;
+    SymbolId ident_name;
 
     NodeRef type;
     NodeRef value;
 } NodeLet;
 
-TokenRef node_let_token(const Parser*, NodeLet*);
-NodeRefSlice node_let_children(const Parser*, NodeLet*);
-
-extern NodeVTable NODE_IMPL_LET;
-
 NodeRef node_let_parse(Parser*, TokenRef visiblity);
 
 #endif
\ No newline at end of file
@@ -5,8 +5,12 @@ TokenRef node_literal_token(const Parser* parser, NodeLiteral* literal) {
     return literal->token;
 }
 
+NodeRefSlice node_literal_children(const Parser* parser, NodeLiteral* literal) {
+    return (NodeRefSlice){.len = 0, .data = NULL};
+}
+
 TypeRef node_literal_type(const Parser* parser, NodeLiteral* literal) {
-    Token* token = arrlist_get(&parser->tokens, literal->token);
+    Token* token = tokbuf_get(&parser->tokens, literal->token);
     switch (token->type) {
 	case TOKEN_LIT_INT: return TYPEREF_GENERIC_INT;
 	case TOKEN_LIT_FLOAT: return TYPEREF_GENERIC_FLOAT;
@@ -25,19 +29,9 @@ NodeRef node_literal_parse(Parser* parser) {
 		RET_ERROR(parser,"expected int, float, or string literal");
 	}
 
-    NodeLiteral* out = malloc(sizeof(NodeLiteral));
+    NodeLiteral* out = parser_allocnode(parser, sizeof(NodeLiteral));
     RET_IF_OOM(parser, out);
-    out->vtable = &NODE_IMPL_LITERAL;
+    out->kind = NODE_LITERAL;
     out->token = tokref;
     return parser_addnode(parser, (Node*)out);
 }
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_LITERAL = {
-    .name = "Literal",
-    .type = (void*)node_literal_type,
-    .children = NULL,
-    .token = (void*)node_literal_token,
-};
-#pragma GCC diagnostic pop
\ No newline at end of file
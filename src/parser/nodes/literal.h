@@ -5,16 +5,11 @@
 
 #include "../../tokenizer/tokenizer.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeLiteral {
+    NodeKind kind;
     TokenRef token;
 } NodeLiteral;
 
-TypeRef node_literal_type(const Parser*, NodeLiteral*);
-TokenRef node_literal_token(const Parser*, NodeLiteral*);
-
-extern NodeVTable NODE_IMPL_LITERAL;
-
 NodeRef node_literal_parse(Parser*);
 
 #endif
\ No newline at end of file
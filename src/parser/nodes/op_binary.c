@@ -1,5 +1,9 @@
 #include "op_binary.h"
 #include "op_unary.h"
+#include "ident.h"
+#include "func_call.h"
+#include "index.h"
+#include "field.h"
 
 TypeRef node_op_binary_type(const Parser* parser, NodeOpBinary* op) {
     return op->type;
@@ -14,56 +18,6 @@ TokenRef node_op_binary_token(const Parser* parser, NodeOpBinary* op) {
     return op->op;
 }
 
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_OP_BINARY = {
-    .name = "OpBinary",
-    .type = node_op_binary_type,
-    .children = node_op_binary_children,
-    .token = node_op_binary_token
-};
-#pragma GCC diagnostic pop
-
-#define DEFINE_OP_LEFT(name, parse_stronger, test_op, rt_func, err_str) \
-	static NodeRef parse_##name(Parser* parser) { \
-		NodeRef lhs = parse_stronger(parser); \
-		RET_IF_ERR(parser,lhs); \
-\
-		for (;;) { \
-			if (!test_op(parser_getpeek(parser)->type)) return lhs; \
-			TokenRef op = parser_consume(parser); \
-\
-			NodeRef rhs = parse_stronger(parser); \
-			RET_IF_ERR(parser,rhs); \
-\
-			NodeOpBinary* out = malloc(sizeof(NodeOpBinary)); \
-			out->vtable = &NODE_IMPL_OP_BINARY; \
-			out->op = op; \
-\
-			Node* lhs_node = arrlist_get(&parser->nodes, lhs); \
-			Node* rhs_node = arrlist_get(&parser->nodes, rhs); \
-			if (lhs_node->vtable->type == NULL || rhs_node->vtable->type == NULL) { \
-				RET_ERROR(parser, "expected expression, found statement in binary op"); \
-			} \
-\
-			TypeRef ret_type = rt_func(parser, lhs_node->vtable->type(parser, lhs_node), rhs_node->vtable->type(parser, rhs_node)); \
-			if (ret_type == TYPEREF_ERR) { \
-                RET_ERROR(parser,err_str); \
-			} \
-            out->type = ret_type; \
-            out->children[0] = lhs; \
-            out->children[1] = rhs; \
-\
-			lhs = parser_addnode(parser, (Node*)out); \
-		}\
-	}
-
-#define IS_OP_MUL(type) ((type) == TOKEN_MUL || (type) == TOKEN_DIV || (type) == TOKEN_MOD || (type) == TOKEN_SHIFT_LEFT || (type) == TOKEN_SHIFT_RIGHT || (type) == TOKEN_BIT_AND)
-#define IS_OP_ADD(type) ((type) == TOKEN_ADD || (type) == TOKEN_SUB || (type) == TOKEN_BIT_OR || (type) == TOKEN_BIT_XOR)
-#define IS_OP_CMP(type) ((type) == TOKEN_CMP_EQ || (type) == TOKEN_CMP_NE || (type) == TOKEN_CMP_LE || (type) == TOKEN_CMP_GE || (type) == TOKEN_CMP_LT || (type) == TOKEN_CMP_GT)
-#define IS_OP_AND(type) ((type) == TOKEN_BOOL_AND)
-#define IS_OP_OR(type) ((type) == TOKEN_BOOL_OR)
-
 static inline TypeRef rt_op(Parser* parser, TypeRef lhs, TypeRef rhs) {
 	if (!type_can_coerce(&parser->types ,rhs, lhs)) {
 		return TYPEREF_ERR;
@@ -83,12 +37,136 @@ inline static  TypeRef rt_bool(Parser* parser, TypeRef lhs, TypeRef rhs) {
 	return TYPEREF_BOOL;
 }
 
-DEFINE_OP_LEFT(op_mul, /*TODO node_grouping_parse*/ node_op_unary_parse, IS_OP_MUL, rt_op, "incompatible lhs and rhs types")
-DEFINE_OP_LEFT(op_add, parse_op_mul, IS_OP_ADD, rt_op, "incompatible lhs and rhs types")
-DEFINE_OP_LEFT(op_cmp, parse_op_add, IS_OP_CMP, rt_cmp, "incompatible lhs and rhs types")
-DEFINE_OP_LEFT(op_and, parse_op_cmp, IS_OP_AND, rt_bool, "lhs and rhs must be bool")
-DEFINE_OP_LEFT(op_or, parse_op_and, IS_OP_OR, rt_bool, "lhs and rhs must be bool")
+typedef struct {
+	uint8_t prec; // PREC_NONE if the token isn't an infix or postfix operator
+	bool right; // right-associative
+	TypeRef (*rt)(Parser* parser, TypeRef lhs, TypeRef rhs);
+	const char* err;
+} OpInfo;
+
+#define ERR_TYPES "incompatible lhs and rhs types"
+#define OP_MUL { PREC_MUL, false, rt_op, ERR_TYPES }
+#define OP_ADD { PREC_ADD, false, rt_op, ERR_TYPES }
+#define OP_CMP { PREC_CMP, false, rt_cmp, ERR_TYPES }
+#define OP_ASSIGN { PREC_ASSIGN, true, rt_op, ERR_TYPES }
+#define OP_POSTFIX { PREC_POSTFIX }
+
+static const OpInfo OPS[] = {
+	[TOKEN_MUL] = OP_MUL, [TOKEN_DIV] = OP_MUL, [TOKEN_MOD] = OP_MUL,
+	[TOKEN_SHIFT_LEFT] = OP_MUL, [TOKEN_SHIFT_RIGHT] = OP_MUL, [TOKEN_BIT_AND] = OP_MUL,
+
+	[TOKEN_ADD] = OP_ADD, [TOKEN_SUB] = OP_ADD, [TOKEN_BIT_OR] = OP_ADD, [TOKEN_BIT_XOR] = OP_ADD,
+
+	[TOKEN_CMP_EQ] = OP_CMP, [TOKEN_CMP_NE] = OP_CMP, [TOKEN_CMP_LE] = OP_CMP,
+	[TOKEN_CMP_GE] = OP_CMP, [TOKEN_CMP_LT] = OP_CMP, [TOKEN_CMP_GT] = OP_CMP,
+
+	[TOKEN_BOOL_AND] = { PREC_AND, false, rt_bool, "lhs and rhs must be bool" },
+	[TOKEN_BOOL_OR] = { PREC_OR, false, rt_bool, "lhs and rhs must be bool" },
+
+	[TOKEN_EQ] = OP_ASSIGN,
+	[TOKEN_EQ_ADD] = OP_ASSIGN, [TOKEN_EQ_SUB] = OP_ASSIGN, [TOKEN_EQ_MUL] = OP_ASSIGN,
+	[TOKEN_EQ_DIV] = OP_ASSIGN, [TOKEN_EQ_MOD] = OP_ASSIGN, [TOKEN_EQ_BIT_AND] = OP_ASSIGN,
+	[TOKEN_EQ_BIT_OR] = OP_ASSIGN, [TOKEN_EQ_BIT_XOR] = OP_ASSIGN,
+	[TOKEN_EQ_SHIFT_LEFT] = OP_ASSIGN, [TOKEN_EQ_SHIFT_RIGHT] = OP_ASSIGN,
+
+	[TOKEN_PAREN_LEFT] = OP_POSTFIX, [TOKEN_BRACKET_LEFT] = OP_POSTFIX, [TOKEN_DOT] = OP_POSTFIX,
+};
+
+// whether node names a place that can be assigned to: a mutable binding,
+// a field or element of one, or an element behind a mut pointer or slice
+static bool is_assignable(const Parser* parser, NodeRef ref) {
+	for (;;) {
+		Node* node = arrlist_get(&parser->nodes, ref);
+		switch (node->kind) {
+		case NODE_IDENT:
+			return ((NodeIdent*)node)->mut;
+		case NODE_FIELD:
+			ref = ((NodeField*)node)->child;
+			break;
+		case NODE_INDEX: {
+			NodeIndex* index = (NodeIndex*)node;
+			if (index->colon != TOKREF_ERR) return false;
+			ref = index->children[0];
+			Type operand = typetable_get(&parser->types, parser_nodetype(parser, ref))->type;
+			if (operand.tag != TYPE_ARRAY) return (operand.data & TYPE_MUT) != 0;
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+}
+
+static NodeRef parse_postfix(Parser* parser, NodeRef lhs, TokenType type) {
+	switch (type) {
+	case TOKEN_PAREN_LEFT: return node_func_call_parse(parser, lhs);
+	case TOKEN_BRACKET_LEFT: return node_index_parse(parser, lhs);
+	case TOKEN_DOT: return node_field_parse(parser, lhs);
+	default: RET_ERROR(parser, "expected postfix operator");
+	}
+}
+
+// precedence climbing: operators at the same level are folded into lhs
+// in this loop, so only a change of level (or a prefix operator) recurses
+static NodeRef parse_prec(Parser* parser, Prec min) {
+	NodeRef lhs = node_op_unary_parse(parser);
+	RET_IF_ERR(parser, lhs);
+
+	for (;;) {
+		TokenType type = parser_getpeek(parser)->type;
+		if ((size_t)type >= sizeof(OPS) / sizeof(*OPS)) return lhs;
+		const OpInfo* info = &OPS[type];
+		if (info->prec == PREC_NONE || info->prec < min) return lhs;
+
+		if (info->prec == PREC_POSTFIX) {
+			lhs = parse_postfix(parser, lhs, type);
+			RET_IF_ERR(parser, lhs);
+			continue;
+		}
+
+		if (info->prec == PREC_ASSIGN && !is_assignable(parser, lhs)) {
+			RET_ERROR(parser, "left side of assignment is not a mutable place");
+		}
+
+		TokenRef op = parser_consume(parser);
+		NodeRef rhs = node_op_binary_parse_prec(parser, info->right ? info->prec : info->prec + 1);
+		RET_IF_ERR(parser, rhs);
+
+		TypeRef lhs_type = parser_nodetype(parser, lhs);
+		TypeRef rhs_type = parser_nodetype(parser, rhs);
+		if (lhs_type == TYPEREF_ERR || rhs_type == TYPEREF_ERR) {
+			RET_ERROR(parser, "expected expression, found statement in binary op");
+		}
+
+		TypeRef ret_type = info->rt(parser, lhs_type, rhs_type);
+		if (ret_type == TYPEREF_ERR) {
+			RET_ERROR(parser, info->err);
+		}
+
+		NodeOpBinary* out = parser_allocnode(parser, sizeof(NodeOpBinary));
+		RET_IF_OOM(parser, out);
+		out->kind = NODE_OP_BINARY;
+		out->op = op;
+		out->type = ret_type;
+		out->children[0] = lhs;
+		out->children[1] = rhs;
+
+		lhs = parser_addnode(parser, (Node*)out);
+		RET_IF_ERR(parser, lhs);
+	}
+}
+
+// every recursive path through the expression parsers comes back here,
+// so this is where nesting is bounded
+NodeRef node_op_binary_parse_prec(Parser* parser, Prec min) {
+	if (parser->depth >= PARSER_MAX_DEPTH) RET_ERROR(parser, "expression nested too deeply");
+
+	parser->depth++;
+	NodeRef ref = parse_prec(parser, min);
+	parser->depth--;
+	return ref;
+}
 
 NodeRef node_op_binary_parse(Parser* parser) {
-    return parse_op_or(parser);
+    return node_op_binary_parse_prec(parser, PREC_ASSIGN);
 }
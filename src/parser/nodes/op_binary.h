@@ -3,19 +3,28 @@
 
 #include "../parser.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeOpBinary {
+    NodeKind kind;
     TokenRef op;
     NodeRef children[2]; // [lhs, rhs]
     TypeRef type;
 } NodeOpBinary;
 
-TypeRef node_op_binary_type(const Parser* parser, NodeOpBinary* op);
-NodeRefSlice node_op_binary_children(const Parser* parser, NodeOpBinary* op);
-TokenRef node_op_binary_token(const Parser* parser, NodeOpBinary* op);
-
-extern NodeVTable NODE_IMPL_OP_BINARY;
+// how tightly an operator binds. an expression parsed at some
+// precedence contains only operators that bind at least that tightly.
+typedef enum {
+    PREC_NONE,
+    PREC_ASSIGN, // = += -= ...; right-associative
+    PREC_OR,
+    PREC_AND,
+    PREC_CMP,
+    PREC_ADD,
+    PREC_MUL,
+    PREC_POSTFIX, // call, index, slice, .
+} Prec;
 
+// parses a full expression, including assignments
 NodeRef node_op_binary_parse(Parser* parser);
+NodeRef node_op_binary_parse_prec(Parser* parser, Prec min);
 
 #endif
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include <stdlib.h>
 #include "op_unary.h"
-#include "func_call.h"
-#include "literal.h"
+#include "op_binary.h"
+#include "grouping.h"
 
 #define CHECK(type_) (parser_getpeek(parser)->type == (type_))
 
@@ -20,20 +20,9 @@ TokenRef node_op_unary_token(const Parser* parser, NodeOpUnary* node) {
     return node->op;
 }
 
-
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
-NodeVTable NODE_IMPL_OP_UNARY = {
-    .name = "OpUnary",
-    .children = node_op_unary_children,
-    .token = node_op_unary_token,
-    .type = node_op_unary_type
-};
-#pragma GCC diagnostic pop
-
 #define IS_OP_UNARY(type) ((type) == TOKEN_ADD || (type) == TOKEN_SUB || (type) == TOKEN_MUL || (type) == TOKEN_BIT_NOT || (type) == TOKEN_BOOL_NOT || (type) == TOKEN_BIT_AND || (type) == TOKEN_QUESTION)
 NodeRef node_op_unary_parse(Parser* parser) {
-	if (!IS_OP_UNARY(parser_getpeek(parser)->type) && !CHECK(TOKEN_BRACKET_LEFT)) return node_func_call_parse(parser); //node_func_call_parse(parser);
+	if (!IS_OP_UNARY(parser_getpeek(parser)->type) && !CHECK(TOKEN_BRACKET_LEFT)) return node_grouping_parse(parser);
 
 	TokenRef op_ref = parser_consume(parser);
     Token* op = parser_gettok(parser, op_ref);
@@ -47,7 +36,8 @@ NodeRef node_op_unary_parse(Parser* parser) {
 				RET_ERROR(parser, "expected integer literal or ]");
 			}
 
-			data = num_ref;
+			// array length
+			data = parser_gettokval(parser, num_ref)->i;
 		}
 	}
 
@@ -58,20 +48,21 @@ NodeRef node_op_unary_parse(Parser* parser) {
 		}
 	}
 
-    NodeRef child = node_op_unary_parse(parser);
+    // postfix operators bind tighter than prefix ones
+    NodeRef child = node_op_binary_parse_prec(parser, PREC_POSTFIX);
     RET_IF_ERR(parser, child);
 
-    NodeOpUnary* node = malloc(sizeof(NodeOpUnary));
+    NodeOpUnary* node = parser_allocnode(parser, sizeof(NodeOpUnary));
     RET_IF_OOM(parser, node);
-    node->vtable = &NODE_IMPL_OP_UNARY;
+    node->kind = NODE_OP_UNARY;
     node->op = op_ref;
     node->child = child;
     node->data = data;
     
-    Node* child_node = arrlist_get(&parser->nodes, child);
-    TypeRef child_typeref = child_node->vtable->type(parser, child_node);
-    TypeEntry* child_typeentry = typetable_get(&parser->types, child_typeref);
-    Type* child_type = &child_typeentry->type;
+    TypeRef child_typeref = parser_nodetype(parser, child);
+    if (child_typeref == TYPEREF_ERR) RET_ERROR(parser, "expected expression, found statement in unary op");
+    const TypeEntry* child_typeentry = typetable_get(&parser->types, child_typeref);
+    const Type* child_type = &child_typeentry->type;
 
 	switch (child_type->tag) {
 	case TYPE_INT:
@@ -132,6 +123,7 @@ NodeRef node_op_unary_parse(Parser* parser) {
             .tag= TYPE_PTR
         };
         node->type = typetable_add(&parser->types, "", type);
+        if (node->type == TYPEREF_ERR) RET_ERROR(parser, "too many types");
     } else {
         node->type = child_typeref;
     }
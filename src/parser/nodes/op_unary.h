@@ -3,19 +3,15 @@
 
 #include "../parser.h"
 
-typedef struct {
-    const NodeVTable* vtable;
+typedef struct NodeOpUnary {
+    NodeKind kind;
+    uint64_t data; // array length, or TYPE_MUT
     TokenRef op;
     NodeRef child;
     TypeRef type;
-    uint64_t data;
 } NodeOpUnary;
 
-TypeRef node_op_unary_type(const Parser* parser, NodeOpUnary* node);
-NodeRefSlice node_op_unary_children(const Parser* parser, NodeOpUnary* node);
-TokenRef node_op_unary_token(const Parser* parser, NodeOpUnary* node);
+// parses prefix operators and their operand, or else a primary expression
 NodeRef node_op_unary_parse(Parser* parser);
 
-extern NodeVTable NODE_IMPL_OP_UNARY;
-
 #endif
\ No newline at end of file
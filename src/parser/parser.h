@@ -4,73 +4,174 @@
 #include "parser_forward.h"
 #include "node.h"
 #include "symbols.h"
+#include "tokbuf.h"
+#include "arena.h"
 
 #include "../tokenizer/tokenizer.h"
+#include "../tokenizer/strpool.h"
 #include "types.h"
 #include <arrlist.h>
 
+// deepest expression nesting the parser accepts before failing, rather
+// than overflowing the C stack. each level costs a few parse frames.
+#ifndef PARSER_MAX_DEPTH
+#define PARSER_MAX_DEPTH 1024
+#endif
+
 struct Parser {
 	Tokenizer tok;
 
 	const char* error;
 //	ArrList errors;
 
-	// last element is next token to be consumed
-	ArrList tokens;
+	// every token lexed so far; the last one is the lookahead
+	TokenBuf tokens;
+	// next token to be consumed. behind the lookahead after a rollback,
+	// in which case tokens are replayed from the buffer.
+	TokenRef next;
+
+	// contents of string literals, by TokenValue.str
+	StrPool strings;
+	// identifiers and qualified names, by SymbolId
+	StrPool names;
+	// reused for joining qualified names
+	char* scratch;
+	size_t scratch_cap;
+	// children of the calls being parsed, before they're copied to their node
+	NodeRef* pending;
+	size_t pending_len;
+	size_t pending_cap;
 
+	// nodes and their trailing arrays live in the arena
+	Arena arena;
 	ArrList nodes;
+	// type of each node, by NodeRef: resolved once, when the node is
+	// added. TYPEREF_ERR for statements.
+	TypeRef* node_types;
+	size_t node_types_cap;
 
 	TypeTable types;
 
-	// maximum 256 depth
-	SymbolTable scopes[256];
-	size_t current_scope;
+	// how many expressions are being parsed inside each other, which
+	// bounds the parser's recursion; see PARSER_MAX_DEPTH
+	size_t depth;
+
+	// every open scope, over the static builtins (SYMBOL_BUILTINS)
+	SymbolTable symbols;
 };
 
+// lexes one more token onto the end of the token buffer. once TOKREF_ERR
+// tokens have been lexed, fails and turns the lookahead into an EOF instead.
+static bool parser_lex(Parser* parser) {
+	if (parser->tokens.len >= TOKREF_ERR) {
+		parser->error = "too many tokens";
+		parser_gettok(parser, parser->tokens.len - 1)->type = TOKEN_EOF;
+		return false;
+	}
+
+	Token* slot = tokbuf_push(&parser->tokens);
+	if (slot == NULL) {
+		fprintf(stderr, "parser_lex: out of memory\n");
+		abort();
+	}
+	*slot = tok_next(&parser->tok);
+	if (slot->type == TOKEN_LIT_INT || slot->type == TOKEN_LIT_FLOAT || slot->type == TOKEN_LIT_STR || slot->type == TOKEN_IDENT) {
+		*tokbuf_value(&parser->tokens, parser->tokens.len - 1) = parser->tok.value;
+	}
+	return true;
+}
+
 static void parser_init(Parser* parser, const char* src) {
 	tok_init(&parser->tok, src);
+	strpool_init(&parser->strings);
+	strpool_init_over(&parser->names, &SYMBOL_NAMES);
+	parser->tok.strings = &parser->strings;
+	parser->tok.idents = &parser->names;
+	parser->scratch = NULL;
+	parser->scratch_cap = 0;
+	parser->pending = NULL;
+	parser->pending_len = 0;
+	parser->pending_cap = 0;
 	parser->error = NULL;
-	arrlist_init(&parser->tokens, 32);
+	parser->depth = 0;
+	tokbuf_init(&parser->tokens);
+	arena_init(&parser->arena);
 	arrlist_init(&parser->nodes, 32);
+	parser->node_types = NULL;
+	parser->node_types_cap = 0;
 	typetable_init(&parser->types);
-	symbols_init(&parser->scopes[0]);
-	symbols_add_builtin(&parser->scopes[0], &parser->types);
-	parser->current_scope = 0;
+	symbols_init(&parser->symbols);
 
-	Token tok = tok_next(&parser->tok);
-	Token* tok_m = malloc(sizeof(Token));
-	memcpy(tok_m, &tok, sizeof(Token));
-	arrlist_add(&parser->tokens, tok_m);
+	parser_lex(parser);
+	parser->next = 0;
 }
 
+// frees everything the parser owns, including all of its nodes
+static void parser_free(Parser* parser) {
+	tok_free(&parser->tok);
+	tokbuf_free(&parser->tokens);
+	strpool_free(&parser->strings);
+	strpool_free(&parser->names);
+	free(parser->scratch);
+	free(parser->pending);
+	arena_free(&parser->arena);
+	arrlist_deinit(&parser->nodes);
+	free(parser->node_types);
+	typetable_free(&parser->types);
+	symbols_free(&parser->symbols);
+}
+
+// starts over on src as if just initialized, but keeps all of the
+// parser's memory for reuse. every ref and pointer into the previous
+// parse is invalid afterwards.
+static void parser_reset(Parser* parser, const char* src) {
+	tok_reset(&parser->tok, src);
+	strpool_clear(&parser->strings);
+	strpool_clear(&parser->names);
+	parser->pending_len = 0;
+	parser->error = NULL;
+	parser->depth = 0;
+	tokbuf_clear(&parser->tokens);
+	arena_reset(&parser->arena);
+	parser->nodes.len = 0;
+	typetable_clear(&parser->types);
+	symbols_clear(&parser->symbols);
+
+	parser_lex(parser);
+	parser->next = 0;
+}
+
+// consumes the next token, lexing a new lookahead if needed,
+// and returns its ref
 static TokenRef parser_consume(Parser* parser) {
-	Token tok = tok_next(&parser->tok);
-	Token* tok_m = malloc(sizeof(Token));
-	if (tok_m == NULL) {
-		fprintf(stderr, "parser_consume: out of memory\n");
-		abort();
+	if (parser->next + 1 == parser->tokens.len) {
+		// EOF stays the lookahead; lexing again would read past the '\0'
+		if (parser_gettok(parser, parser->next)->type == TOKEN_EOF) return parser->next;
+		if (!parser_lex(parser)) return parser->next;
 	}
-	memcpy(tok_m, &tok, sizeof(Token));
-
-	TokenRef ref = parser->tokens.len - 1;
-	arrlist_add(&parser->tokens, tok_m);
-	return ref;
+	return parser->next++;
 }
 
 static inline Token* parser_gettok(Parser* parser, TokenRef ref) {
-	return arrlist_get(&parser->tokens, ref);
+	return tokbuf_get(&parser->tokens, ref);
+}
+
+// decoded value of an int, float, or string literal token,
+// or the SymbolId of an identifier
+static inline const TokenValue* parser_gettokval(const Parser* parser, TokenRef ref) {
+	return tokbuf_value(&parser->tokens, ref);
 }
 
 static inline TokenRef parser_peek(Parser* parser) {
-	return parser->tokens.len - 1;
+	return parser->next;
 }
 
 static inline bool parser_peek_is(Parser* parser, TokenType type) {
-	return parser_gettok(parser, parser->tokens.len - 1)->type == type;
+	return parser_gettok(parser, parser->next)->type == type;
 }
 
 static inline bool parser_consume_if(Parser* parser, TokenType type, TokenRef* out) {
-	if (((Token*)arrlist_get(&parser->tokens, parser_peek(parser)))->type == type) {
+	if (parser_getpeek(parser)->type == type) {
 		*out = parser_consume(parser);
 		return true;
 	} else {
@@ -100,9 +201,84 @@ static inline Token* parser_getpeek(Parser* parser) {
 
 #define PARSER_EXPECT_TOKEN(varname, parser, tokentype, err) if (parser_getpeek(parser)->type != (tokentype)) { RET_ERROR(parser, err); } NodeRef varname = parser_consume(parser);
 
+// position to return to if a speculative parse fails
+typedef struct {
+	ArenaMark arena;
+	size_t nodes_len;
+	size_t pending_len;
+	TokenRef next;
+	const char* error;
+	SymbolScope symbols;
+} ParserMark;
+
+static inline ParserMark parser_mark(const Parser* parser) {
+	return (ParserMark){
+		.arena = arena_mark(&parser->arena),
+		.nodes_len = parser->nodes.len,
+		.pending_len = parser->pending_len,
+		.next = parser->next,
+		.error = parser->error,
+		.symbols = {.bindings_len = parser->symbols.bindings_len, .depth = parser->symbols.depth},
+	};
+}
+
+// drops every node added and every symbol bound since the mark, and
+// rewinds to its token
+static inline void parser_rollback(Parser* parser, ParserMark mark) {
+	arena_rollback(&parser->arena, mark.arena);
+	parser->nodes.len = mark.nodes_len;
+	parser->pending_len = mark.pending_len;
+	parser->next = mark.next;
+	parser->error = mark.error;
+	symbols_exit(&parser->symbols, mark.symbols);
+}
+
+// allocates a node (with room for size - sizeof(Node) bytes of fields)
+// in the parser's arena. freed by parser_rollback or parser_free.
+static inline void* parser_allocnode(Parser* parser, size_t size) {
+	return arena_alloc(&parser->arena, size);
+}
+
+// pushes a child onto the pending stack; see parser_pending_take
+static inline bool parser_pending_push(Parser* parser, NodeRef ref) {
+	if (parser->pending_len == parser->pending_cap) {
+		size_t cap = parser->pending_cap == 0 ? 16 : parser->pending_cap * 2;
+		NodeRef* pending = realloc(parser->pending, cap * sizeof(NodeRef));
+		if (pending == NULL) return false;
+		parser->pending = pending;
+		parser->pending_cap = cap;
+	}
+	parser->pending[parser->pending_len++] = ref;
+	return true;
+}
+
+// copies the children pushed since `base` to out and pops them
+static inline void parser_pending_take(Parser* parser, size_t base, NodeRef* out) {
+	memcpy(out, &parser->pending[base], (parser->pending_len - base) * sizeof(NodeRef));
+	parser->pending_len = base;
+}
+
+// adds a finished node, resolving its type
 static inline NodeRef parser_addnode(Parser* parser, Node* node) {
-	arrlist_add(&parser->nodes, node);
-	return parser->nodes.len - 1;
+	if (parser->nodes.len >= NODE_ERR) RET_ERROR(parser, "too many nodes");
+
+	NodeRef ref = parser->nodes.len;
+	if (ref == parser->node_types_cap) {
+		size_t cap = parser->node_types_cap == 0 ? 32 : parser->node_types_cap * 2;
+		TypeRef* node_types = realloc(parser->node_types, cap * sizeof(TypeRef));
+		RET_IF_OOM(parser, node_types);
+		parser->node_types = node_types;
+		parser->node_types_cap = cap;
+	}
+	parser->node_types[ref] = node_type(parser, node);
+
+	RET_IF_OOM(parser, arrlist_add(&parser->nodes, node) ? node : NULL);
+	return ref;
+}
+
+// the type of an added node, or TYPEREF_ERR for a statement
+static inline TypeRef parser_nodetype(const Parser* parser, NodeRef ref) {
+	return parser->node_types[ref];
 }
 
 #endif
\ No newline at end of file
@@ -4,11 +4,14 @@
 #include "../tokenizer/tokenizer.h"
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
-typedef size_t TokenRef;
-#define TOKREF_ERR SIZE_MAX
+// refs are 32-bit indices; a parse is limited to TOKREF_ERR tokens
+// and NODE_ERR nodes
+typedef uint32_t TokenRef;
+#define TOKREF_ERR UINT32_MAX
 
-typedef size_t NodeRef;
+typedef uint32_t NodeRef;
 
 typedef struct {
     size_t len;
@@ -18,6 +21,8 @@ typedef struct {
 
 typedef struct Parser Parser;
 static void parser_init(Parser* parser, const char* src);
+static void parser_free(Parser* parser);
+static void parser_reset(Parser* parser, const char* src);
 static TokenRef parser_consume(Parser* parser);
 static inline Token* parser_gettok(Parser* parser, TokenRef ref);
 static inline TokenRef parser_peek(Parser* parser);
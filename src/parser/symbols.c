@@ -1,40 +1,142 @@
 #include "symbols.h"
+#include "builtin_names.h"
+
+_Static_assert(BUILTIN_NAMES_LEN == SYMBOL_BUILTINS_LEN, "build/builtin_names.h is out of date");
+
+const StrPool SYMBOL_NAMES = {
+	.data = (char*)builtin_names_data,
+	.data_len = BUILTIN_NAMES_DATA_LEN,
+	.entries = (struct StrPoolEntry*)builtin_names_entries,
+	.len = BUILTIN_NAMES_LEN,
+	.slots = (uint32_t*)builtin_names_slots,
+	.slots_cap = BUILTIN_NAMES_SLOTS_CAP,
+};
+
+const SymbolEntry SYMBOL_BUILTINS[SYMBOL_BUILTINS_LEN] = {
+	#define TYPE(name, ref) [SYMBOL_BUILTIN_##name] = { .node = NODE_ERR, .type = TYPEREF_TYPE, .ref_self = ref },
+	#define VALUE(name, ref) [SYMBOL_BUILTIN_##name] = { .node = NODE_ERR, .type = ref },
+	BUILTIN_SYMBOLS(TYPE, VALUE)
+	#undef TYPE
+	#undef VALUE
+};
 
 void symbols_init(SymbolTable* table) {
-	rhmap_init(&table->symbols, 64, rhmap_djb2_str, rhmap_eq_str);
+	table->keys = NULL;
+	table->heads = NULL;
+	table->len = 0;
+	table->cap = 0;
+	table->bindings = NULL;
+	table->bindings_len = 0;
+	table->bindings_cap = 0;
+	table->depth = 0;
 }
 
-bool symbols_add(SymbolTable* table, char* name, SymbolEntry entry) {
-	if (rhmap_has(&table->symbols, name)) {
+// ids are dense, so spread them with a multiplicative hash
+static size_t symbols_slot(SymbolId name, size_t cap) {
+	return (size_t)((name * 0x9e3779b9u) & (cap - 1));
+}
+
+static bool symbols_grow(SymbolTable* table) {
+	size_t cap = table->cap == 0 ? 16 : table->cap * 2;
+	SymbolId* keys = malloc(cap * sizeof(SymbolId));
+	SymbolRef* heads = malloc(cap * sizeof(SymbolRef));
+	if (keys == NULL || heads == NULL) {
+		free(keys);
+		free(heads);
 		return false;
 	}
+	for (size_t i = 0; i < cap; i++) keys[i] = SYMBOL_NONE;
 
-	SymbolEntry* ptr = malloc(sizeof(SymbolEntry));
-	if (ptr == NULL) return false;
-	memcpy(ptr, &entry, sizeof(SymbolEntry));
+	for (size_t i = 0; i < table->cap; i++) {
+		if (table->keys[i] == SYMBOL_NONE) continue;
+		size_t slot = symbols_slot(table->keys[i], cap);
+		while (keys[slot] != SYMBOL_NONE) slot = (slot + 1) & (cap - 1);
+		keys[slot] = table->keys[i];
+		heads[slot] = table->heads[i];
+	}
 
-	return rhmap_set(&table->symbols, name, ptr);
+	free(table->keys);
+	free(table->heads);
+	table->keys = keys;
+	table->heads = heads;
+	table->cap = cap;
+	return true;
 }
 
-bool symbols_add_builtin(SymbolTable* table, TypeTable* types) {
-	#define ENTRY(name_, type_) symbols_add(table, #name_, (SymbolEntry){.node = NODE_ERR, .type = type_ });
-	#define TYPE(name_, typeref) symbols_add(table, #name_, (SymbolEntry){ .node = NODE_ERR, .type = TYPEREF_TYPE, .ref_self= typeref});
-	TYPE(i8, TYPEREF_I8); TYPE(i16, TYPEREF_I16); TYPE(i32, TYPEREF_I32); TYPE(i64, TYPEREF_I64); TYPE(isize, TYPEREF_ISIZE);
-	TYPE(u8, TYPEREF_U8); TYPE(u16, TYPEREF_U16); TYPE(u32, TYPEREF_U32); TYPE(u64, TYPEREF_U64); TYPE(usize, TYPEREF_USIZE);
-	TYPE(f16, TYPEREF_F16); TYPE(f32, TYPEREF_F32); TYPE(f64, TYPEREF_F64); TYPE(f64x, TYPEREF_F64X);
-	TYPE(type, TYPEREF_TYPE); TYPE(void, TYPEREF_VOID); TYPE(bool, TYPEREF_BOOL);
+// the slot for name, claimed (with no binding) if it didn't have one.
+// names stay in the table once seen, so SIZE_MAX only means out of memory.
+static size_t symbols_claim(SymbolTable* table, SymbolId name) {
+	// keep the table at most 3/4 full
+	if ((table->len + 1) * 4 > table->cap * 3 && !symbols_grow(table)) return SIZE_MAX;
+
+	size_t slot = symbols_slot(name, table->cap);
+	for (; table->keys[slot] != SYMBOL_NONE; slot = (slot + 1) & (table->cap - 1)) {
+		if (table->keys[slot] == name) return slot;
+	}
+
+	table->keys[slot] = name;
+	table->heads[slot] = SYMBOL_NONE;
+	table->len++;
+	return slot;
+}
 
-	ENTRY("true", TYPEREF_BOOL);
-	ENTRY("false", TYPEREF_BOOL);
-	ENTRY("null", TYPEREF_VOID);
+bool symbols_add(SymbolTable* table, SymbolId name, SymbolEntry entry) {
+	size_t slot = symbols_claim(table, name);
+	if (slot == SIZE_MAX) return false;
+
+	SymbolRef head = table->heads[slot];
+	if (head != SYMBOL_NONE && table->bindings[head].depth == table->depth) return false;
+	if (head == SYMBOL_NONE && name < SYMBOL_BUILTINS_LEN && table->depth == 0) return false;
+
+	if (table->bindings_len >= SYMBOL_NONE) return false;
+	if (table->bindings_len == table->bindings_cap) {
+		size_t cap = table->bindings_cap == 0 ? 32 : table->bindings_cap * 2;
+		SymbolBinding* bindings = realloc(table->bindings, cap * sizeof(SymbolBinding));
+		if (bindings == NULL) return false;
+		table->bindings = bindings;
+		table->bindings_cap = cap;
+	}
+
+	SymbolRef ref = table->bindings_len++;
+	table->bindings[ref] = (SymbolBinding){.name = name, .depth = table->depth, .shadowed = head, .entry = entry};
+	table->heads[slot] = ref;
 	return true;
 }
 
-SymbolEntry* symbols_get(SymbolTable* table, const char* name) {
-	return rhmap_get(&table->symbols, (void*)name);
+const SymbolEntry* symbols_get(const SymbolTable* table, SymbolId name) {
+	if (table->cap != 0) {
+		size_t slot = symbols_slot(name, table->cap);
+		for (; table->keys[slot] != SYMBOL_NONE; slot = (slot + 1) & (table->cap - 1)) {
+			if (table->keys[slot] != name) continue;
+			SymbolRef head = table->heads[slot];
+			if (head != SYMBOL_NONE) return &table->bindings[head].entry;
+			break;
+		}
+	}
+	return name < SYMBOL_BUILTINS_LEN ? &SYMBOL_BUILTINS[name] : NULL;
+}
+
+void symbols_exit(SymbolTable* table, SymbolScope scope) {
+	// innermost first, so a name bound twice ends up with its outer binding
+	while (table->bindings_len > scope.bindings_len) {
+		const SymbolBinding* binding = &table->bindings[--table->bindings_len];
+		size_t slot = symbols_slot(binding->name, table->cap);
+		while (table->keys[slot] != binding->name) slot = (slot + 1) & (table->cap - 1);
+		table->heads[slot] = binding->shadowed;
+	}
+	table->depth = scope.depth;
+}
+
+void symbols_clear(SymbolTable* table) {
+	for (size_t i = 0; i < table->cap; i++) table->keys[i] = SYMBOL_NONE;
+	table->len = 0;
+	table->bindings_len = 0;
+	table->depth = 0;
 }
 
 void symbols_free(SymbolTable* table) {
-	// memory leak!
-	return rhmap_deinit(&table->symbols);
+	free(table->keys);
+	free(table->heads);
+	free(table->bindings);
+	symbols_init(table);
 }
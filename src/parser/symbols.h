@@ -1,26 +1,88 @@
 #ifndef _SYMBOLS_H
 #define _SYMBOLS_H
 
-#include <rhmap.h>
+#include <stdint.h>
 #include "../tokenizer/tokenizer.h"
+#include "../tokenizer/strpool.h"
 #include "parser_forward.h"
 #include "types.h"
 #include "node.h"
+#include "builtins.h"
+
+// an interned (possibly qualified) name; an id in the parser's name pool
+typedef StrId SymbolId;
+#define SYMBOL_NONE UINT32_MAX
 
 typedef struct {
 	NodeRef node;
 	TypeRef type;
     TypeRef ref_self; // if type is TYPE_TYPE
+    bool mut; // can be assigned to
 } SymbolEntry;
 
+// ids of the builtins' names, in any pool over SYMBOL_NAMES
+enum {
+    #define X(name, ref) SYMBOL_BUILTIN_##name,
+    BUILTIN_SYMBOLS(X, X)
+    #undef X
+    SYMBOL_BUILTINS_LEN
+};
+
+// shared by every parser and never written: the interned builtin names,
+// and what each of them is bound to in the outermost scope
+extern const StrPool SYMBOL_NAMES;
+extern const SymbolEntry SYMBOL_BUILTINS[SYMBOL_BUILTINS_LEN];
+
+typedef uint32_t SymbolRef; // index of a binding
+
+typedef struct {
+    SymbolId name;
+    uint32_t depth; // of the scope it was made in
+    SymbolRef shadowed; // binding of the same name it hides, or SYMBOL_NONE
+    SymbolEntry entry;
+} SymbolBinding;
+
+// every scope at once, over the builtins: a hash table (open addressing on the id) from each
+// name to its innermost binding, over a stack of bindings. the stack is
+// also the undo log; leaving a scope pops its bindings and puts back
+// whatever they shadowed. no string is hashed or compared.
 typedef struct {
-    RhMap /* SymbolEntry* */ symbols;
+    SymbolId* keys; // SYMBOL_NONE if empty
+    SymbolRef* heads; // SYMBOL_NONE if the name isn't bound right now
+    size_t len;
+    size_t cap;
+
+    SymbolBinding* bindings;
+    size_t bindings_len;
+    size_t bindings_cap;
+
+    uint32_t depth; // 0 is the outermost scope
 } SymbolTable;
 
+// where to return to when leaving a scope
+typedef struct {
+    size_t bindings_len;
+    uint32_t depth;
+} SymbolScope;
+
 void symbols_init(SymbolTable* table);
-bool symbols_add(SymbolTable* table, char* name, SymbolEntry entry);
-bool symbols_add_builtin(SymbolTable* table, TypeTable* types);
-SymbolEntry* symbols_get(SymbolTable* table, const char* name);
+// binds name in the innermost scope. fails if it's already bound there
+// (builtins count as bound in the outermost scope), or if out of memory.
+bool symbols_add(SymbolTable* table, SymbolId name, SymbolEntry entry);
+// the innermost binding of name, or its builtin, or NULL. valid until
+// the next symbols_add or symbols_exit.
+const SymbolEntry* symbols_get(const SymbolTable* table, SymbolId name);
 void symbols_free(SymbolTable* table);
+// unbinds everything and forgets every name, keeping the capacity
+void symbols_clear(SymbolTable* table);
+
+// unbinds everything bound since scope was entered
+void symbols_exit(SymbolTable* table, SymbolScope scope);
+
+static inline SymbolScope symbols_enter(SymbolTable* table) {
+    SymbolScope scope = {.bindings_len = table->bindings_len, .depth = table->depth};
+    table->depth++;
+    return scope;
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include "tokbuf.h"
+
+void tokbuf_init(TokenBuf* buf) {
+	buf->pages = NULL;
+	buf->values = NULL;
+	buf->pages_len = 0;
+	buf->pages_cap = 0;
+	buf->len = 0;
+}
+
+Token* tokbuf_push(TokenBuf* buf) {
+	size_t page = buf->len >> TOKBUF_PAGE_BITS;
+	if (page == buf->pages_len) {
+		if (buf->pages_len == buf->pages_cap) {
+			size_t cap = buf->pages_cap == 0 ? 8 : buf->pages_cap * 2;
+			Token** pages = realloc(buf->pages, cap * sizeof(Token*));
+			if (pages == NULL) return NULL;
+			buf->pages = pages;
+			TokenValue** values = realloc(buf->values, cap * sizeof(TokenValue*));
+			if (values == NULL) return NULL;
+			buf->values = values;
+			buf->pages_cap = cap;
+		}
+
+		Token* data = malloc(TOKBUF_PAGE_LEN * sizeof(Token));
+		if (data == NULL) return NULL;
+		TokenValue* values = malloc(TOKBUF_PAGE_LEN * sizeof(TokenValue));
+		if (values == NULL) {
+			free(data);
+			return NULL;
+		}
+		buf->pages[buf->pages_len] = data;
+		buf->values[buf->pages_len] = values;
+		buf->pages_len++;
+	}
+
+	Token* slot = &buf->pages[page][buf->len & (TOKBUF_PAGE_LEN - 1)];
+	buf->len++;
+	return slot;
+}
+
+void tokbuf_free(TokenBuf* buf) {
+	for (size_t i = 0; i < buf->pages_len; i++) {
+		free(buf->pages[i]);
+		free(buf->values[i]);
+	}
+	free(buf->pages);
+	free(buf->values);
+	tokbuf_init(buf);
+}
+
+void tokbuf_clear(TokenBuf* buf) {
+	buf->len = 0;
+}
@@ -0,0 +1,42 @@
+#ifndef _TOKBUF_H
+#define _TOKBUF_H
+
+#include <stddef.h>
+#include "parser_forward.h"
+#include "../tokenizer/tokenizer.h"
+
+// tokens are stored inline in fixed-size pages, so a Token*
+// stays valid for the lifetime of the buffer even as it grows.
+#define TOKBUF_PAGE_BITS 10
+#define TOKBUF_PAGE_LEN ((size_t)1 << TOKBUF_PAGE_BITS)
+
+typedef struct {
+	Token** pages;
+	// decoded literal values, paged in parallel with the tokens
+	TokenValue** values;
+	size_t pages_len;
+	size_t pages_cap;
+
+	size_t len;
+} TokenBuf;
+
+void tokbuf_init(TokenBuf* buf);
+// returns a pointer to a new slot at the end of the buffer,
+// or NULL if out of memory. the slot's value is at tokbuf_value(buf, len - 1).
+Token* tokbuf_push(TokenBuf* buf);
+void tokbuf_free(TokenBuf* buf);
+// empties the buffer, keeping its pages for reuse
+void tokbuf_clear(TokenBuf* buf);
+
+static inline Token* tokbuf_get(const TokenBuf* buf, TokenRef ref) {
+	if (ref >= buf->len) return NULL;
+	return &buf->pages[ref >> TOKBUF_PAGE_BITS][ref & (TOKBUF_PAGE_LEN - 1)];
+}
+
+// only meaningful for literal and identifier tokens
+static inline TokenValue* tokbuf_value(const TokenBuf* buf, TokenRef ref) {
+	if (ref >= buf->len) return NULL;
+	return &buf->values[ref >> TOKBUF_PAGE_BITS][ref & (TOKBUF_PAGE_LEN - 1)];
+}
+
+#endif
@@ -1,62 +1,17 @@
 #include "types.h"
 
-bool type_is_eq(TypeTable* table, TypeRef from, TypeRef to) {
-	#define HEADER \
-		TypeEntry* from_entry = typetable_get(table, (from)); \
-		TypeEntry* to_entry = typetable_get(table, (to))
-
-	#define FROM (from_entry->type)
-	#define TO (to_entry->type)
-
-	HEADER;
-
-	if (FROM.tag != TO.tag) return false;
-	switch (FROM.tag) {
-	case TYPE_ARRAY:
-	case TYPE_PTR:
-	case TYPE_SLICE:
-		return type_is_eq(table, FROM.child, TO.child) && FROM.data == TO.data;
-
-	case TYPE_UINT:
-	case TYPE_INT:
-	case TYPE_FLOAT:
-		return FROM.data == TO.data;
-
-	case TYPE_BOOL: return FROM.data == TO.data;
-	case TYPE_VOID:
-	case TYPE_TYPE:
-		return true;
-
-	case TYPE_ENUM: return from == to;
-	case TYPE_UNION:
-	case TYPE_STRUCT:;
-		TypeFields* from_fields = (TypeFields*)FROM.data;
-		TypeFields* to_fields = (TypeFields*)TO.data;
-		if (from_fields->fields.len != to_fields->fields.len) return false;
-		for (size_t i = 0; i < to_fields->fields.len; i++) {
-			if (!type_is_eq(table, 
-					((TypeFieldsField*)arrlist_get(&to_fields->fields, i))->type,
-					((TypeFieldsField*)arrlist_get(&from_fields->fields, i))->type)) return false;
-		}
-		return true;
-
-	case TYPE_FUNC:;
-		TypeFuncData* from_data = UINT_TO_PTR(FROM.data);
-		TypeFuncData* to_data = UINT_TO_PTR(TO.data);
+bool type_is_eq(const TypeTable* table, TypeRef from, TypeRef to) {
+	return from == to;
+}
 
-		if (from_data->arg_types.len != to_data->arg_types.len || from_data->varardic != to_data->varardic) return false;
-		if (!type_is_eq(table, from_data->ret_type, to_data->ret_type)) return false;
+#define HEADER \
+	const TypeEntry* from_entry = typetable_get(table, (from)); \
+	const TypeEntry* to_entry = typetable_get(table, (to))
 
-		for (size_t i = 0; i < from_data->arg_types.len; i++) {
-			if (!type_is_eq(table, 
-				(TypeRef)arrlist_get(&to_data->arg_types, i),
-				(TypeRef)arrlist_get(&from_data->arg_types, i))) return false;
-		}
-		return true;
-	}
-}
+#define FROM (from_entry->type)
+#define TO (to_entry->type)
 
-bool type_can_coerce(TypeTable* table, TypeRef from, TypeRef to) {
+static bool type_compute_coerce(const TypeTable* table, TypeRef from, TypeRef to) {
 	HEADER;
 
 	switch (TO.tag) {
@@ -90,7 +45,7 @@ bool type_can_coerce(TypeTable* table, TypeRef from, TypeRef to) {
 	}
 }
 
-bool type_can_cast(TypeTable* table, TypeRef from, TypeRef to) {
+static bool type_compute_cast(const TypeTable* table, TypeRef from, TypeRef to) {
 	HEADER;
 
 	switch (TO.tag) {
@@ -118,82 +73,313 @@ bool type_can_cast(TypeTable* table, TypeRef from, TypeRef to) {
 	case TYPE_FUNC:
 		return type_is_eq(table, from, to);
 	}
-
-	#undef HEADER
-	#undef FROM
-	#undef TO
 }
 
+#undef HEADER
+#undef FROM
+#undef TO
+
 bool type_is_runtime(TypeTable* table, TypeRef type) {
-	TypeEntry* type_entry = typetable_get(table, type);
+	const TypeEntry* type_entry = typetable_get(table, type);
 
 	if (type_entry->type.tag == TYPE_TYPE) return false;
 	if (type_entry->type.tag == TYPE_INT && type_entry->type.data == 0) return false;
 	return true;
 }
 
-TypeRef typetable_add(TypeTable* table, const char* name, Type type) {
-	size_t ref = table->entries.len;
+static inline uint32_t type_mix(uint64_t h, uint64_t x) {
+	h = (h ^ x) * 0x9e3779b97f4a7c15;
+	return h ^ (h >> 32);
+}
 
-	TypeEntry* entry = malloc(sizeof(TypeEntry));
-	if (entry == NULL) {
-		fprintf(stderr, "typetable_add: OOM\n");
-		abort();
+static bool type_data_is_ptr(TypeTag tag) {
+	return tag == TYPE_STRUCT || tag == TYPE_UNION || tag == TYPE_FUNC;
+}
+
+// child is only meaningful for some tags; the others leave it unset
+static bool type_has_child(TypeTag tag) {
+	return tag == TYPE_ARRAY || tag == TYPE_PTR || tag == TYPE_SLICE || tag == TYPE_ENUM || tag == TYPE_FUNC;
+}
+
+// hashes what type_shallow_eq compares
+static uint32_t type_hash(Type type) {
+	uint64_t h = type_mix(type.tag, type_has_child(type.tag) ? type.child : 0);
+
+	if (type.tag == TYPE_STRUCT || type.tag == TYPE_UNION) {
+		TypeFields* fields = UINT_TO_PTR(type.data);
+		for (size_t i = 0; i < fields->fields.len; i++) {
+			TypeFieldsField* field = arrlist_get(&fields->fields, i);
+			for (const char* c = field->name; *c != '\0'; c++) h = type_mix(h, *c);
+			h = type_mix(h, field->type);
+		}
+	} else if (type.tag == TYPE_FUNC) {
+		TypeFuncData* func = UINT_TO_PTR(type.data);
+		h = type_mix(h, func->varardic);
+		h = type_mix(h, func->ret_type);
+		for (size_t i = 0; i < func->arg_types.len; i++) {
+			h = type_mix(h, PTR_TO_UINT(TypeRef, arrlist_get(&func->arg_types, i)));
+		}
+	} else {
+		h = type_mix(h, type.data);
 	}
-	entry->name = name;
-	entry->type = type;
+	return (uint32_t)h;
+}
 
-	if (!arrlist_add(&table->entries, entry)) {
-		fprintf(stderr, "typetable_add: OOM\n");
+// children are interned before their parents, so they compare by ref
+static bool type_shallow_eq(Type a, Type b) {
+	if (a.tag != b.tag) return false;
+	if (type_has_child(a.tag) && a.child != b.child) return false;
+	if (!type_data_is_ptr(a.tag)) return a.data == b.data;
+
+	if (a.tag == TYPE_FUNC) {
+		TypeFuncData* from = UINT_TO_PTR(a.data);
+		TypeFuncData* to = UINT_TO_PTR(b.data);
+		if (from->varardic != to->varardic || from->ret_type != to->ret_type) return false;
+		if (from->arg_types.len != to->arg_types.len) return false;
+		for (size_t i = 0; i < from->arg_types.len; i++) {
+			if (arrlist_get(&from->arg_types, i) != arrlist_get(&to->arg_types, i)) return false;
+		}
+		return true;
+	}
+
+	TypeFields* from = UINT_TO_PTR(a.data);
+	TypeFields* to = UINT_TO_PTR(b.data);
+	if (from->fields.len != to->fields.len) return false;
+	for (size_t i = 0; i < from->fields.len; i++) {
+		TypeFieldsField* from_field = arrlist_get(&from->fields, i);
+		TypeFieldsField* to_field = arrlist_get(&to->fields, i);
+		if (from_field->type != to_field->type || strcmp(from_field->name, to_field->name) != 0) return false;
+	}
+	return true;
+}
+
+static void typetable_index(TypeTable* table, TypeRef ref, uint32_t hash);
+
+static void typetable_grow(TypeTable* table) {
+	size_t cap = table->slots_cap == 0 ? 64 : table->slots_cap * 2;
+	struct TypeSlot* old = table->slots;
+	size_t old_cap = table->slots_cap;
+
+	table->slots = malloc(cap * sizeof(struct TypeSlot));
+	if (table->slots == NULL) {
+		fprintf(stderr, "typetable_grow: OOM\n");
 		abort();
 	}
+	table->slots_cap = cap;
+	for (size_t i = 0; i < cap; i++) table->slots[i].ref = TYPEREF_ERR;
 
+	for (size_t i = 0; i < old_cap; i++) {
+		if (old[i].ref != TYPEREF_ERR) typetable_index(table, old[i].ref, old[i].hash);
+	}
+	free(old);
+}
+
+static void typetable_index(TypeTable* table, TypeRef ref, uint32_t hash) {
+	size_t mask = table->slots_cap - 1;
+	size_t i = hash & mask;
+	while (table->slots[i].ref != TYPEREF_ERR) i = (i + 1) & mask;
+	table->slots[i] = (struct TypeSlot){ .ref = ref, .hash = hash };
+}
+
+static TypeRef typetable_append(TypeTable* table, const char* name, Type type) {
+	size_t ref = typetable_len(table);
+	if (ref >= TYPEREF_ERR) return TYPEREF_ERR;
+
+	if (table->len == table->cap) {
+		size_t cap = table->cap == 0 ? 64 : table->cap * 2;
+		TypeEntry* entries = realloc(table->entries, cap * sizeof(TypeEntry));
+		if (entries == NULL) {
+			fprintf(stderr, "typetable_add: OOM\n");
+			abort();
+		}
+		table->entries = entries;
+		table->cap = cap;
+	}
+
+	table->entries[table->len++] = (TypeEntry){ .name = name, .type = type };
 	return ref;
 }
 
-TypeEntry* typetable_get(const TypeTable* table, TypeRef ref) {
-	return arrlist_get(&table->entries, ref);
+// the builtins that a type could be equal to, or TYPEREF_ERR
+static TypeRef typetable_find_builtin(Type type) {
+	if (type_has_child(type.tag) && type.tag != TYPE_SLICE) return TYPEREF_ERR;
+	for (TypeRef ref = 0; ref < TYPEREF_BUILTINS_LEN; ref++) {
+		if (type_shallow_eq(TYPE_BUILTINS[ref].type, type)) return ref;
+	}
+	return TYPEREF_ERR;
 }
 
-void typetable_init(TypeTable* table) {
-	arrlist_init(&table->entries, 64);
+TypeRef typetable_add(TypeTable* table, const char* name, Type type) {
+	if (type.tag == TYPE_ENUM) return typetable_append(table, name, type);
 
-	#define MAKE(ident, name_, info) do { \
-		TypeEntry* entry = malloc(sizeof(TypeEntry)); \
-		if (entry == NULL) abort(); \
-		entry->name = name_; \
-		entry->type = (Type)info; \
-		table->entries.data[TYPEREF_##ident] = entry; \
-	} while(0)
-	MAKE(VOID, "void", ((Type){.tag=TYPE_VOID, .data=0}));
-	MAKE(BOOL, "bool", ((Type){.tag=TYPE_BOOL, .data=0}));
+	TypeRef builtin = typetable_find_builtin(type);
+	if (builtin != TYPEREF_ERR) return builtin;
 
-	MAKE(I8, "i8", ((Type){.tag=TYPE_INT, .data=8}));
-	MAKE(I16, "i16", ((Type){.tag=TYPE_INT, .data=16}));
-	MAKE(I32, "i32", ((Type){.tag=TYPE_INT, .data=32}));
-	MAKE(I64, "i64", ((Type){.tag=TYPE_INT, .data=64}));
-	MAKE(ISIZE, "isize", ((Type){.tag=TYPE_INT, .data=1}));
+	uint32_t hash = type_hash(type);
+	if (table->slots_cap != 0) {
+		size_t mask = table->slots_cap - 1;
+		for (size_t i = hash & mask; table->slots[i].ref != TYPEREF_ERR; i = (i + 1) & mask) {
+			struct TypeSlot slot = table->slots[i];
+			if (slot.hash == hash && type_shallow_eq(typetable_get(table, slot.ref)->type, type)) return slot.ref;
+		}
+	}
 
-	MAKE(U8, "u8", ((Type){.tag=TYPE_UINT, .data=8}));
-	MAKE(U16, "u16", ((Type){.tag=TYPE_UINT, .data=16}));
-	MAKE(U32, "u32", ((Type){.tag=TYPE_UINT, .data=32}));
-	MAKE(U64, "u64", ((Type){.tag=TYPE_UINT, .data=64}));
-	MAKE(USIZE, "usize", ((Type){.tag=TYPE_UINT, .data=1}));
+	TypeRef ref = typetable_append(table, name, type);
+	if (ref == TYPEREF_ERR) return TYPEREF_ERR;
 
-	MAKE(F16, "f16", ((Type){.tag=TYPE_FLOAT, .data=16}));
-	MAKE(F32, "f32", ((Type){.tag=TYPE_FLOAT, .data=32}));
-	MAKE(F64, "f64", ((Type){.tag=TYPE_FLOAT, .data=64}));
-	MAKE(F64X, "f64x", ((Type){.tag=TYPE_FLOAT, .data=80}));
+	// keep the load at or below 1/2
+	if (table->len * 2 > table->slots_cap) typetable_grow(table);
+	typetable_index(table, ref, hash);
+	return ref;
+}
+
+// per-relation bits in the cache; a result is only valid if its KNOWN bit is set
+#define TYPE_REL_COERCE_KNOWN 0x1
+#define TYPE_REL_COERCE 0x2
+#define TYPE_REL_CAST_KNOWN 0x4
+#define TYPE_REL_CAST 0x8
+
+static void typetable_rels_grow(TypeTable* table) {
+	size_t cap = table->rels_cap == 0 ? 64 : table->rels_cap * 2;
+	struct TypeRel* old = table->rels;
+	size_t old_cap = table->rels_cap;
+
+	table->rels = malloc(cap * sizeof(struct TypeRel));
+	if (table->rels == NULL) {
+		fprintf(stderr, "typetable_rels_grow: OOM\n");
+		abort();
+	}
+	table->rels_cap = cap;
+	for (size_t i = 0; i < cap; i++) table->rels[i].from = TYPEREF_ERR;
+
+	size_t mask = cap - 1;
+	for (size_t i = 0; i < old_cap; i++) {
+		if (old[i].from == TYPEREF_ERR) continue;
+		size_t j = type_mix(old[i].from, old[i].to) & mask;
+		while (table->rels[j].from != TYPEREF_ERR) j = (j + 1) & mask;
+		table->rels[j] = old[i];
+	}
+	free(old);
+}
+
+// the cached bits for (from, to), added empty if there aren't any yet
+static uint8_t* typetable_rel(TypeTable* table, TypeRef from, TypeRef to) {
+	if (from < TYPEREF_BUILTINS_LEN && to < TYPEREF_BUILTINS_LEN) return &table->builtin_rels[from][to];
 
-	MAKE(GENERIC_INT, "'gint", ((Type){.tag=TYPE_INT, .data=0}));
-	MAKE(GENERIC_FLOAT, "'gfloat", ((Type){.tag=TYPE_FLOAT, .data=0}));
+	// keep the load at or below 1/2
+	if ((table->rels_len + 1) * 2 > table->rels_cap) typetable_rels_grow(table);
 
-	MAKE(TYPE, "type", ((Type){.tag=TYPE_TYPE, .data=0}));
-	MAKE(STR, "'str", ((Type){.tag=TYPE_SLICE, .data=0, .child=TYPEREF_U8}));
+	size_t mask = table->rels_cap - 1;
+	size_t i = type_mix(from, to) & mask;
+	for (; table->rels[i].from != TYPEREF_ERR; i = (i + 1) & mask) {
+		if (table->rels[i].from == from && table->rels[i].to == to) return &table->rels[i].bits;
+	}
+	table->rels[i] = (struct TypeRel){ .from = from, .to = to, .bits = 0 };
+	table->rels_len++;
+	return &table->rels[i].bits;
+}
 
-	table->entries.len = 20;
+bool type_can_coerce(TypeTable* table, TypeRef from, TypeRef to) {
+	// types are interned, so this is the same type; not worth a slot
+	if (from == to) return true;
+
+	uint8_t* bits = typetable_rel(table, from, to);
+	if ((*bits & TYPE_REL_COERCE_KNOWN) != 0) {
+		table->rel_hits++;
+		return (*bits & TYPE_REL_COERCE) != 0;
+	}
+
+	table->rel_misses++;
+	bool out = type_compute_coerce(table, from, to);
+	*bits |= TYPE_REL_COERCE_KNOWN | (out ? TYPE_REL_COERCE : 0);
+	return out;
+}
+
+bool type_can_cast(TypeTable* table, TypeRef from, TypeRef to) {
+	if (from == to) return true;
+
+	uint8_t* bits = typetable_rel(table, from, to);
+	if ((*bits & TYPE_REL_CAST_KNOWN) != 0) {
+		table->rel_hits++;
+		return (*bits & TYPE_REL_CAST) != 0;
+	}
+
+	table->rel_misses++;
+	bool out = type_compute_cast(table, from, to);
+	*bits |= TYPE_REL_CAST_KNOWN | (out ? TYPE_REL_CAST : 0);
+	return out;
+}
+
+TypeTableStats typetable_stats(const TypeTable* table) {
+	return (TypeTableStats){
+		.types = typetable_len(table),
+		.rels_cached = table->rels_len,
+		.rel_hits = table->rel_hits,
+		.rel_misses = table->rel_misses,
+	};
+}
+
+const TypeEntry TYPE_BUILTINS[TYPEREF_BUILTINS_LEN] = {
+	#define BUILTIN(ident, name_, ...) [TYPEREF_##ident] = { .name = name_, .type = { __VA_ARGS__ } }
+	BUILTIN(VOID, "void", .tag=TYPE_VOID),
+	BUILTIN(BOOL, "bool", .tag=TYPE_BOOL),
+
+	BUILTIN(I8, "i8", .tag=TYPE_INT, .data=8),
+	BUILTIN(I16, "i16", .tag=TYPE_INT, .data=16),
+	BUILTIN(I32, "i32", .tag=TYPE_INT, .data=32),
+	BUILTIN(I64, "i64", .tag=TYPE_INT, .data=64),
+	BUILTIN(ISIZE, "isize", .tag=TYPE_INT, .data=1),
+
+	BUILTIN(U8, "u8", .tag=TYPE_UINT, .data=8),
+	BUILTIN(U16, "u16", .tag=TYPE_UINT, .data=16),
+	BUILTIN(U32, "u32", .tag=TYPE_UINT, .data=32),
+	BUILTIN(U64, "u64", .tag=TYPE_UINT, .data=64),
+	BUILTIN(USIZE, "usize", .tag=TYPE_UINT, .data=1),
+
+	BUILTIN(F16, "f16", .tag=TYPE_FLOAT, .data=16),
+	BUILTIN(F32, "f32", .tag=TYPE_FLOAT, .data=32),
+	BUILTIN(F64, "f64", .tag=TYPE_FLOAT, .data=64),
+	BUILTIN(F64X, "f64x", .tag=TYPE_FLOAT, .data=80),
+
+	BUILTIN(GENERIC_INT, "'gint", .tag=TYPE_INT, .data=0),
+	BUILTIN(GENERIC_FLOAT, "'gfloat", .tag=TYPE_FLOAT, .data=0),
+
+	BUILTIN(TYPE, "type", .tag=TYPE_TYPE),
+	BUILTIN(STR, "'str", .tag=TYPE_SLICE, .data=0, .child=TYPEREF_U8),
+	#undef BUILTIN
+};
+
+void typetable_init(TypeTable* table) {
+	table->entries = NULL;
+	table->len = 0;
+	table->cap = 0;
+	table->slots = NULL;
+	table->slots_cap = 0;
+
+	memset(table->builtin_rels, 0, sizeof(table->builtin_rels));
+	table->rels = NULL;
+	table->rels_len = 0;
+	table->rels_cap = 0;
+	table->rel_hits = 0;
+	table->rel_misses = 0;
+}
+
+void typetable_clear(TypeTable* table) {
+	table->len = 0;
+	for (size_t i = 0; i < table->slots_cap; i++) table->slots[i].ref = TYPEREF_ERR;
+
+	// relations between builtins hold in every table, so they stay
+	for (size_t i = 0; i < table->rels_cap; i++) table->rels[i].from = TYPEREF_ERR;
+	table->rels_len = 0;
+	table->rel_hits = 0;
+	table->rel_misses = 0;
+}
 
-	#undef MAKE
+void typetable_free(TypeTable* table) {
+	free(table->entries);
+	free(table->slots);
+	free(table->rels);
+	typetable_init(table);
 }
 
-//const char* const TYPE_ANON = "";
+//const char* const TYPE_ANON = "";
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -32,13 +33,13 @@ typedef enum {
 #define TYPE_MUT 0x2
 #define TYPE_OPT 0x1
 
-typedef size_t TypeRef;
+typedef uint32_t TypeRef;
 //extern const char* const TYPE_ANON;
 
 typedef struct {
 	TypeTag tag;
-	uint64_t data;
 	TypeRef child;
+	uint64_t data;
 } Type;
 
 typedef struct {
@@ -64,9 +65,10 @@ typedef struct {
 
 typedef struct TypeTable TypeTable;
 
-bool type_is_eq(TypeTable* table, TypeRef from, TypeRef to);
+// types are interned, so this is just from == to
+bool type_is_eq(const TypeTable* table, TypeRef from, TypeRef to);
 
-// auto-coerce
+// auto-coerce. this and type_can_cast are memoized in the table.
 bool type_can_coerce(TypeTable* table, TypeRef from, TypeRef to);
 
 bool type_can_cast(TypeTable* table, TypeRef from, TypeRef to);
@@ -100,16 +102,75 @@ enum {
 
 	TYPEREF_TYPE,
 	TYPEREF_STR, // []const u8
+
+	TYPEREF_BUILTINS_LEN
 };
 
-#define TYPEREF_ERR SIZE_MAX
+#define TYPEREF_ERR UINT32_MAX
+
+// the builtin types, shared by every table; refs below TYPEREF_BUILTINS_LEN
+extern const TypeEntry TYPE_BUILTINS[TYPEREF_BUILTINS_LEN];
 
-TypeEntry* typetable_get(const TypeTable* table, TypeRef ref);
+// returns the ref of the type equal to `type` (keeping that type's name),
+// adding it under `name` if there isn't one yet. enums are nominal and
+// always added. the table never owns TypeFields or TypeFuncData.
+// returns TYPEREF_ERR if the table is full.
 TypeRef typetable_add(TypeTable* table, const char* name, Type type);
 void typetable_init(TypeTable* table);
+void typetable_free(TypeTable* table);
+// drops every type but the builtins, and their cached relations,
+// keeping the capacity
+void typetable_clear(TypeTable* table);
 
 struct TypeTable {
-	ArrList entries;
+	// types after the builtins, by value: ref TYPEREF_BUILTINS_LEN + i is entries[i]
+	TypeEntry* entries;
+	size_t len;
+	size_t cap;
+
+	// hash index over entries, by structure; open addressing.
+	// the builtins aren't in it.
+	struct TypeSlot {
+		uint32_t ref; // TYPEREF_ERR if empty
+		uint32_t hash;
+	}* slots;
+	size_t slots_cap;
+
+	// memoized type_can_coerce/type_can_cast, as TYPE_REL_* bits per
+	// (from, to). pairs of builtins are direct-mapped; the rest are in
+	// an open-addressed cache. types never change once added, so
+	// nothing is ever evicted.
+	uint8_t builtin_rels[TYPEREF_BUILTINS_LEN][TYPEREF_BUILTINS_LEN];
+	struct TypeRel {
+		TypeRef from; // TYPEREF_ERR if empty
+		TypeRef to;
+		uint8_t bits;
+	}* rels;
+	size_t rels_len;
+	size_t rels_cap;
+
+	size_t rel_hits;
+	size_t rel_misses;
 };
 
+typedef struct {
+	size_t types; // including the builtins
+	size_t rels_cached; // pairs outside the builtins
+	size_t rel_hits;
+	size_t rel_misses;
+} TypeTableStats;
+
+TypeTableStats typetable_stats(const TypeTable* table);
+
+// valid until the next typetable_add
+static inline const TypeEntry* typetable_get(const TypeTable* table, TypeRef ref) {
+	if (ref < TYPEREF_BUILTINS_LEN) return &TYPE_BUILTINS[ref];
+	return &table->entries[ref - TYPEREF_BUILTINS_LEN];
+}
+
+// number of types, including the builtins
+static inline size_t typetable_len(const TypeTable* table) {
+	return TYPEREF_BUILTINS_LEN + table->len;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "walk.h"
+#include "parser.h"
+
+void node_walk_init(NodeWalk* walk, const Parser* parser, NodeRef root) {
+	walk->parser = parser;
+	walk->stack = NULL;
+	walk->len = 0;
+	walk->cap = 0;
+	node_walk_reset(walk, root);
+}
+
+void node_walk_reset(NodeWalk* walk, NodeRef root) {
+	walk->root = root;
+	walk->len = 0;
+}
+
+void node_walk_free(NodeWalk* walk) {
+	free(walk->stack);
+	walk->stack = NULL;
+	walk->len = 0;
+	walk->cap = 0;
+}
+
+static void walk_push(NodeWalk* walk, NodeRef node, NodeWalkStep* out) {
+	if (walk->len == walk->cap) {
+		size_t cap = walk->cap == 0 ? 64 : walk->cap * 2;
+		NodeWalkFrame* stack = realloc(walk->stack, cap * sizeof(NodeWalkFrame));
+		if (stack == NULL) {
+			fprintf(stderr, "node_walk_next: out of memory\n");
+			abort();
+		}
+		walk->stack = stack;
+		walk->cap = cap;
+	}
+
+	*out = (NodeWalkStep){
+		.node = node,
+		.parent = walk->len != 0 ? walk->stack[walk->len - 1].node : NODE_ERR,
+		.depth = walk->len,
+		.exit = false,
+	};
+	walk->stack[walk->len++] = (NodeWalkFrame){ .node = node, .child = 0 };
+}
+
+bool node_walk_next(NodeWalk* walk, NodeWalkStep* out) {
+	if (walk->root != NODE_ERR) {
+		walk_push(walk, walk->root, out);
+		walk->root = NODE_ERR;
+		return true;
+	}
+	if (walk->len == 0) return false;
+
+	NodeWalkFrame* top = &walk->stack[walk->len - 1];
+	if (top->child != UINT32_MAX) {
+		Node* node = arrlist_get(&walk->parser->nodes, top->node);
+		NodeRefSlice children = node_children(walk->parser, node);
+		// absent children (NODE_ERR, like a let's omitted type) are skipped
+		while (top->child < children.len) {
+			NodeRef child = children.data[top->child++];
+			if (child == NODE_ERR) continue;
+			walk_push(walk, child, out);
+			return true;
+		}
+	}
+
+	walk->len--;
+	*out = (NodeWalkStep){
+		.node = top->node,
+		.parent = walk->len != 0 ? walk->stack[walk->len - 1].node : NODE_ERR,
+		.depth = walk->len,
+		.exit = true,
+	};
+	return true;
+}
+
+void node_visit(const Parser* parser, NodeRef root, const NodeVisitor* visitor, void* ctx) {
+	NodeWalk walk;
+	NodeWalkStep step;
+	node_walk_init(&walk, parser, root);
+	while (node_walk_next(&walk, &step)) {
+		if (step.exit) continue;
+
+		Node* node = arrlist_get(&parser->nodes, step.node);
+		if (!node_visitor_call(visitor, ctx, parser, step.node, node)) node_walk_skip(&walk);
+	}
+	node_walk_free(&walk);
+}
@@ -0,0 +1,64 @@
+#ifndef _WALK_H
+#define _WALK_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "parser_forward.h"
+#include "node.h"
+
+// depth-first walk over the tree under a node, without recursion: the
+// path from the root to the current node is kept on a heap stack, so
+// any depth takes constant C stack and each node is entered and left
+// once. every node is yielded twice, on the way down (pre-order) and on
+// the way back up (post-order). absent children (NODE_ERR) are skipped.
+//
+//     NodeWalk walk;
+//     NodeWalkStep step;
+//     node_walk_init(&walk, parser, root);
+//     while (node_walk_next(&walk, &step)) { ... }
+//     node_walk_free(&walk);
+
+typedef struct {
+	NodeRef node;
+	// index of the next child to enter
+	uint32_t child;
+} NodeWalkFrame;
+
+typedef struct {
+	const Parser* parser;
+	// not entered yet, or NODE_ERR once it has been
+	NodeRef root;
+	NodeWalkFrame* stack;
+	size_t len;
+	size_t cap;
+} NodeWalk;
+
+typedef struct {
+	NodeRef node;
+	// NODE_ERR for the root
+	NodeRef parent;
+	// 0 for the root
+	size_t depth;
+	// false when entering the node, before its children; true when
+	// leaving it, after them
+	bool exit;
+} NodeWalkStep;
+
+void node_walk_init(NodeWalk* walk, const Parser* parser, NodeRef root);
+// starts over from root, keeping the stack's memory
+void node_walk_reset(NodeWalk* walk, NodeRef root);
+void node_walk_free(NodeWalk* walk);
+// the next step of the walk, or false when it's done
+bool node_walk_next(NodeWalk* walk, NodeWalkStep* out);
+
+// right after entering a node, don't enter its children; the next step
+// leaves it
+static inline void node_walk_skip(NodeWalk* walk) {
+	walk->stack[walk->len - 1].child = UINT32_MAX;
+}
+
+// walks the tree under root in pre-order, calling visitor's callback
+// for each node's kind
+void node_visit(const Parser* parser, NodeRef root, const NodeVisitor* visitor, void* ctx);
+
+#endif
@@ -1,8 +1,11 @@
 #include "parser/parser.h"
 #include "parser/nodes/op_binary.h"
+#include "parser/nodes/let.h"
+#include "parser/ast.h"
+#include "parser/walk.h"
 
 void print_type(FILE* out, const Parser* parser, TypeRef typeref) {
-    TypeEntry* entry = typetable_get(&parser->types, typeref);
+    const TypeEntry* entry = typetable_get(&parser->types, typeref);
     Type type = entry->type;
     fprintf(out, "%s (", entry->name[0] == '\0' ? "'anon" : entry->name);
 
@@ -22,75 +25,112 @@ void print_type(FILE* out, const Parser* parser, TypeRef typeref) {
     fprintf(out, ")");
 }
 
-void print_item(const Parser* parser, NodeRef noderef, int indent) {
-    #define PRINT_TABS(n) for (int i = 0; i < (n); i++) putchar('\t')
+// deeper levels all get the same indentation, plus their depth, so a
+// very deep tree doesn't print a quadratic number of tabs
+#define PRINT_MAX_INDENT 64
+
+void print_node(const Parser* parser, NodeRef noderef, int indent) {
+    #define PRINT_TABS(n) for (int i = 0; i < (n) && i < PRINT_MAX_INDENT; i++) putchar('\t')
 
     Node* node = arrlist_get(&parser->nodes, noderef);
 
     PRINT_TABS(indent);
-    printf("\033[4m%s\033[0m\n", node->vtable->name);
+    if (indent > PRINT_MAX_INDENT) printf("(%d) ", indent);
+    printf("\033[4m%s\033[0m\n", node_name(node));
 
-    TokenRef tokenref = node->vtable->token(parser, node);
-    Token* token = arrlist_get(&parser->tokens, tokenref);
+    TokenRef tokenref = node_token(parser, node);
+    Token* token = tokbuf_get(&parser->tokens, tokenref);
 
     PRINT_TABS(indent+1);
-    printf("Token: %.*s (#%d)\n", (int)token->len, token->start, (int)tokenref);
+    printf("Token: %.*s (#%d)\n", (int)token->len, token_start(&parser->tok, token), (int)tokenref);
+
+    if (token->type == TOKEN_LIT_INT || token->type == TOKEN_LIT_FLOAT || token->type == TOKEN_LIT_STR) {
+        const TokenValue* value = parser_gettokval(parser, tokenref);
+        PRINT_TABS(indent+1);
+        if (token->type == TOKEN_LIT_INT) printf("Value: %llu\n", (unsigned long long)value->i);
+        else if (token->type == TOKEN_LIT_FLOAT) printf("Value: %g\n", value->f);
+        else printf("Value: #%u (%zu bytes)\n", value->str, strpool_len(&parser->strings, value->str));
+    }
 
-    if (node->vtable->type != NULL) {
-        TypeRef type = node->vtable->type(parser, node);
+    TypeRef type = parser_nodetype(parser, noderef);
+    if (type != TYPEREF_ERR) {
         PRINT_TABS(indent+1);
         printf("Type: ");
         print_type(stdout, parser, type);
         printf("\n");
     }
 
-    if (node->vtable->children != NULL) {
-        NodeRefSlice children = node->vtable->children(parser, node);
-
+    if (node_children(parser, node).len != 0) {
         PRINT_TABS(indent+1);
         puts("Children:");
-        for (int i = 0; i < (int)children.len; i++) {
-            putchar('\n');
-            print_item(parser, children.data[i], indent+1);
-        }
+    }
+}
+
+void print_item(const Parser* parser, NodeRef root, int indent) {
+    NodeWalk walk;
+    NodeWalkStep step;
+    node_walk_init(&walk, parser, root);
+    while (node_walk_next(&walk, &step)) {
+        if (step.exit) continue;
+        if (step.depth != 0) putchar('\n');
+        print_node(parser, step.node, indent + (int)step.depth);
+    }
+    node_walk_free(&walk);
+}
+
+// dumps the flat arrays, one node per line
+void print_ast(const Parser* parser, const Ast* ast) {
+    static const char* const TAGS[] = {"Literal", "Ident", "OpUnary", "OpBinary", "Let", "FuncCall", "Index", "Slice", "Field"};
+
+    for (AstRef i = 0; i < ast->len; i++) {
+        Token* token = tokbuf_get(&parser->tokens, ast->main_tokens[i]);
+        printf("%u: %-8s %-6.*s lhs=%-10d rhs=%-10d type=%d", i, TAGS[ast->tags[i]],
+            (int)token->len, token_start(&parser->tok, token), (int)ast->data[i].lhs, (int)ast->data[i].rhs, (int)ast->types[i]);
+
+        AstRef buf[3];
+        const AstRef* children;
+        size_t len = ast_children(ast, i, buf, &children);
+        for (size_t j = 0; j < len; j++) printf(" %s%u", j == 0 ? "<- " : "", children[j]);
+        putchar('\n');
     }
 }
 
 void graph_node(FILE* out, const Parser* parser, NodeRef noderef) {
     Node* node = arrlist_get(&parser->nodes, noderef);
-    fprintf(out, "%d [shape=\"rectangle\", label=<<B>%s [%d]</B>", (int)noderef, node->vtable->name, (int)noderef);
+    fprintf(out, "%d [shape=\"rectangle\", label=<<B>%s [%d]</B>", (int)noderef, node_name(node), (int)noderef);
 
-    TokenRef tokenref = node->vtable->token(parser, node);
-    Token* token = arrlist_get(&parser->tokens, tokenref);
+    TokenRef tokenref = node_token(parser, node);
+    Token* token = tokbuf_get(&parser->tokens, tokenref);
 
-    if (token->len != 0 && token->start[0] == '&') {
+    if (token->len != 0 && token_start(&parser->tok, token)[0] == '&') {
         fprintf(out, "<BR />Token: &amp; [%d]\n", (int)tokenref);
 
     } else {
-        fprintf(out, "<BR />Token: %.*s [%d]", (int)token->len, token->start, (int)tokenref);
+        fprintf(out, "<BR />Token: %.*s [%d]", (int)token->len, token_start(&parser->tok, token), (int)tokenref);
     }
 
-    if (node->vtable->type != NULL) {
-        TypeRef type = node->vtable->type(parser, node);
+    TypeRef type = parser_nodetype(parser, noderef);
+    if (type != TYPEREF_ERR) {
         fprintf(out, "<BR />Type: ");
         print_type(out, parser, type);
     }
 
     fprintf(out, ">]\n");
-
-    if (node->vtable->children != NULL) {
-        NodeRefSlice children = node->vtable->children(parser, node);
-
-        for (int i = 0; i < (int)children.len; i++) {
-            fprintf(out, "%d -> %d\n", (int)noderef, (int)children.data[i]);
-            graph_node(out, parser, children.data[i]);
-        }
-    }
 }
 
 void graph_create(FILE* out, const Parser* parser, NodeRef root) {
     fprintf(out, "digraph {\n");
-    graph_node(out, parser, root);
+
+    NodeWalk walk;
+    NodeWalkStep step;
+    node_walk_init(&walk, parser, root);
+    while (node_walk_next(&walk, &step)) {
+        if (step.exit) continue;
+        if (step.parent != NODE_ERR) fprintf(out, "%d -> %d\n", (int)step.parent, (int)step.node);
+        graph_node(out, parser, step.node);
+    }
+    node_walk_free(&walk);
+
     fprintf(out, "}\n");
 }
 
@@ -105,10 +145,39 @@ int main() {
     } else {
         print_item(&parser, ref, 0);
 
+        Ast ast;
+        ast_init(&ast);
+        if (ast_build(&ast, &parser)) {
+            putchar('\n');
+            print_ast(&parser, &ast);
+        }
+        ast_free(&ast);
+
         FILE* out = fopen("out.txt", "w");
         graph_create(out, &parser, ref);
         fclose(out);
     }
 
-    return 0;
+    // a let without a type has an absent child, which the walk skips
+    parser_reset(&parser, "let x = 1 + 2;");
+    ref = node_let_parse(&parser, TOKREF_ERR);
+    if (parser.error != NULL) {
+        printf("error: %s\n", parser.error);
+    } else {
+        putchar('\n');
+        print_item(&parser, ref, 0);
+    }
+
+    // a name bound after a mark no longer resolves once rolled back to it
+    parser_reset(&parser, "x");
+    SymbolId name = strpool_intern(&parser.names, "x", 1);
+    ParserMark mark = parser_mark(&parser);
+    symbols_add(&parser.symbols, name, (SymbolEntry){.node = NODE_ERR, .type = TYPEREF_I32});
+    bool bound = symbols_get(&parser.symbols, name) != NULL;
+    parser_rollback(&parser, mark);
+    bool unbound = symbols_get(&parser.symbols, name) == NULL;
+    printf("\nrollback: %s\n", bound && unbound ? "ok" : "x still resolves");
+
+    parser_free(&parser);
+    return bound && unbound ? 0 : 1;
 }
\ No newline at end of file
@@ -1,45 +1,98 @@
+#include <errno.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "tokenizer.h"
+#include "source.h"
+#include "stream.h"
 
-void main() {
+// returns false at eof
+static bool print_token(Token tok, const char* start, SourcePos pos) {
+	switch (tok.type) {
+		#define PREAK(...) printf(__VA_ARGS__); break
+		case TOKEN_EOF: printf("<eof>\n"); return false;
+		case TOKEN_LIT_STR: PREAK("string<%.*s>", (int)tok.len, start);
+		case TOKEN_IDENT: PREAK("ident<%.*s>", (int)tok.len, start);
+		case TOKEN_LIT_INT: PREAK("int<%.*s>", (int)tok.len, start);
+		case TOKEN_LIT_FLOAT: PREAK("float<%.*s>", (int)tok.len, start);
+
+		case TOKEN_ERR_UNEXPECTED: PREAK("error<unexpected char: %d>", (int)*start);
+		case TOKEN_ERR_FLOAT_REQUIRE_EXP: PREAK("error<float: exponent required>");
+		case TOKEN_ERR_STRING_REQUIRE_TERMINATION: PREAK("error<string: unterminated>");
+		case TOKEN_ERR_STRING_INVALID_ESCAPE: PREAK("error<string: invalid escape>");
+		case TOKEN_ERR_COMMENT_REQUIRE_TERMINATION: PREAK("error<comment: unterminated>");
+		case TOKEN_ERR_NUMBER_OVERFLOW: PREAK("error<number: overflow>");
+		case TOKEN_ERR_GENERIC: PREAK("error<?>");
+
+		case TOKEN_COMMENT:
+		case TOKEN_COMMENT_MULTI:
+			PREAK("comment<%.*s>", (int)tok.len, start);
+
+		case TOKEN_STRUCT ... TOKEN_CONTINUE: PREAK("keyword(%.*s)", (int)tok.len, start);
+		default: PREAK("%.*s", (int)tok.len, start);
+		#undef PREAK
+	}
+	// errors come before TOKEN_EOF
+	if (tok.type < TOKEN_EOF) printf("@%d:%d", pos.line + 1, pos.column + 1);
+	putchar(' ');
+	return true;
+}
+
+static void print_tokens(const char* src) {
+	Tokenizer tokenizer;
+	tok_init(&tokenizer, src);
 	for (;;) {
-		printf("> ");
+		Token tok = tok_next(&tokenizer);
+		if (!print_token(tok, token_start(&tokenizer, &tok), token_position(&tokenizer, &tok))) break;
+	}
+	tok_free(&tokenizer);
+}
 
-		char* line = NULL;
-		size_t n = 0;
-		getline(&line, &n, stdin);
-
-		Tokenizer tokenizer;
-		tok_init(&tokenizer, line);
-		for(;;) {
-			Token tok = tok_next(&tokenizer);
-			switch (tok.type) {
-				#define PREAK(...) printf(__VA_ARGS__); break
-				case TOKEN_EOF: printf("<eof>"); goto endprint;
-				case TOKEN_LIT_STR: PREAK("string<%.*s>", (int)tok.len, tok.start);
-				case TOKEN_IDENT: PREAK("ident<%.*s>", (int)tok.len, tok.start);
-				case TOKEN_LIT_INT: PREAK("int<%.*s>", (int)tok.len, tok.start);
-				case TOKEN_LIT_FLOAT: PREAK("float<%.*s>", (int)tok.len, tok.start);
-
-				case TOKEN_ERR_UNEXPECTED: PREAK("error<unexpected char: %d>", (int)*tok.start);
-				case TOKEN_ERR_FLOAT_REQUIRE_EXP: PREAK("error<float: exponent required>");
-				case TOKEN_ERR_STRING_REQUIRE_TERMINATION: PREAK("error<string: unterminated>");
-				case TOKEN_ERR_COMMENT_REQUIRE_TERMINATION: PREAK("error<comment: unterminated>");
-				case TOKEN_ERR_GENERIC: PREAK("error<?>");
-
-				case TOKEN_COMMENT:
-				case TOKEN_COMMENT_MULTI:
-					PREAK("comment<%.*s>", (int)tok.len, tok.start);
-
-				case TOKEN_STRUCT ... TOKEN_CONTINUE: PREAK("keyword(%.*s)", (int)tok.len, tok.start);
-				default: PREAK("%.*s", (int)tok.len, tok.start);
-				#undef PREAK
+// tokenizes stdin as one stream, a chunk at a time
+static bool print_stream(void) {
+	int fd = 0;
+	TokStream stream;
+	if (!tok_stream_init(&stream, tok_stream_read_fd, &fd, 0)) return false;
+	for (;;) {
+		Token tok = tok_stream_next(&stream);
+		SourcePos pos = tok_stream_position(&stream, tok_stream_offset(&stream));
+		if (!print_token(tok, tok_stream_text(&stream), pos)) break;
+	}
+	bool ok = !stream.error;
+	tok_stream_free(&stream);
+	return ok;
+}
+
+// test-tokenizer [FILE...]
+// with no files, tokenizes stdin line by line; a FILE of "-" streams stdin.
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-") == 0) {
+			if (!print_stream()) {
+				fprintf(stderr, "-: %s\n", strerror(errno));
+				return 1;
 			}
-			putchar(' ');
+			continue;
 		}
 
-		endprint:
-		putchar('\n');
+		SourceFile file;
+		if (!source_open(&file, argv[i])) {
+			fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+			return 1;
+		}
+		print_tokens(file.data);
+		source_close(&file);
 	}
+	if (argc > 1) return 0;
 
+	char* line = NULL;
+	size_t n = 0;
+	for (;;) {
+		printf("> ");
+		if (getline(&line, &n, stdin) < 0) break;
+		print_tokens(line);
+	}
+	free(line);
+	return 0;
 }
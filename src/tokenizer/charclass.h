@@ -0,0 +1,37 @@
+#ifndef _CHARCLASS_H
+#define _CHARCLASS_H
+
+#include <stdint.h>
+
+// byte classes for the lexer. unlike <ctype.h> these do not depend on
+// the locale: every byte >= 0x80 is unclassified.
+enum {
+	CC_IDENT_START = 0x01, // [A-Za-z_]
+	CC_IDENT = 0x02, // [A-Za-z0-9_]
+	CC_DIGIT = 0x04, // [0-9]
+	CC_SPACE = 0x08, // ' ', '\t', '\n', '\v', '\f', '\r'
+	CC_OP_START = 0x10, // first byte of a punctuation or operator token
+};
+
+static const uint8_t CHAR_CLASS[256] = {
+	['a' ... 'z'] = CC_IDENT_START | CC_IDENT,
+	['A' ... 'Z'] = CC_IDENT_START | CC_IDENT,
+	['_'] = CC_IDENT_START | CC_IDENT,
+	['0' ... '9'] = CC_DIGIT | CC_IDENT,
+
+	[' '] = CC_SPACE,
+	['\t' ... '\r'] = CC_SPACE,
+
+	['{'] = CC_OP_START, ['}'] = CC_OP_START,
+	['['] = CC_OP_START, [']'] = CC_OP_START,
+	['('] = CC_OP_START, [')'] = CC_OP_START,
+	[','] = CC_OP_START, [';'] = CC_OP_START, ['.'] = CC_OP_START, [':'] = CC_OP_START,
+	['+'] = CC_OP_START, ['-'] = CC_OP_START, ['*'] = CC_OP_START, ['/'] = CC_OP_START, ['%'] = CC_OP_START,
+	['&'] = CC_OP_START, ['|'] = CC_OP_START, ['^'] = CC_OP_START, ['~'] = CC_OP_START,
+	['!'] = CC_OP_START, ['='] = CC_OP_START, ['<'] = CC_OP_START, ['>'] = CC_OP_START,
+	['?'] = CC_OP_START,
+};
+
+#define CHAR_IS(c, cls) ((CHAR_CLASS[(uint8_t)(c)] & (cls)) != 0)
+
+#endif
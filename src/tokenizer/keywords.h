@@ -0,0 +1,34 @@
+#ifndef _KEYWORDS_H
+#define _KEYWORDS_H
+
+// the single list of keywords. src/gen-keywords.c turns this into the
+// perfect hash table used by tok_ident (build/keyword_hash.h).
+//
+// X(keyword, TOKEN_*)
+#define KEYWORDS(X) \
+	X(struct, TOKEN_STRUCT) \
+	X(union, TOKEN_UNION) \
+	X(enum, TOKEN_ENUM) \
+	X(vec, TOKEN_VEC) \
+	X(restrict, TOKEN_RESTRICT) \
+\
+	X(pub, TOKEN_PUB) \
+	X(ext, TOKEN_EXT) \
+	X(static, TOKEN_STATIC) \
+	X(let, TOKEN_LET) \
+	X(mut, TOKEN_MUT) \
+	X(const, TOKEN_CONST) \
+	X(type, TOKEN_TYPE) \
+	X(func, TOKEN_FUNC) \
+	X(return, TOKEN_RETURN) \
+\
+	X(if, TOKEN_IF) \
+	X(else, TOKEN_ELSE) \
+	X(switch, TOKEN_SWITCH) \
+	X(case, TOKEN_CASE) \
+	X(for, TOKEN_FOR) \
+	X(goto, TOKEN_GOTO) \
+	X(break, TOKEN_BREAK) \
+	X(continue, TOKEN_CONTINUE)
+
+#endif
@@ -0,0 +1,355 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lex_parallel.h"
+#include "strpool.h"
+
+// below this many bytes per chunk, thread overhead dominates
+#ifndef TOK_PARALLEL_MIN_CHUNK
+#define TOK_PARALLEL_MIN_CHUNK (64 * 1024)
+#endif
+
+// chunks per thread, for load balancing
+#define TOK_PARALLEL_OVERSPLIT 4
+
+typedef struct {
+	// [start, end) is the byte range this chunk is responsible for:
+	// every token that starts in it, plus the EOF token for the last chunk
+	size_t start;
+	size_t end;
+
+	Token* tokens;
+	// each token's TokenValue; string and identifier ids are into the
+	// chunk's own pools below until chunk_intern moves them
+	TokenValue* values;
+	size_t len;
+	size_t cap;
+
+	StrPool strings;
+	StrPool idents;
+
+	// position after the last token kept
+	size_t stop;
+
+	// every '\n' the chunk's tokenizer passed
+	LineIndex lines;
+
+	// where the chunk's tokens go in the output, and which of its
+	// newlines (those no earlier chunk recorded) go where
+	size_t out_offset;
+	size_t lines_from;
+	size_t lines_out;
+
+	bool oom;
+} LexChunk;
+
+typedef struct {
+	const char* src;
+	size_t len;
+	LexChunk* chunks;
+	size_t chunks_len;
+
+	size_t next; // atomic work counter
+	void (*work)(void* ctx, LexChunk* chunk);
+	Token* out;
+	TokenValue* out_values;
+	uint32_t* out_lines;
+
+	// the caller's pools, or NULL
+	StrPool* strings;
+	StrPool* idents;
+} LexJob;
+
+static bool chunk_reserve(LexChunk* chunk, size_t cap) {
+	if (cap <= chunk->cap) return true;
+	Token* tokens = realloc(chunk->tokens, cap * sizeof(Token));
+	if (tokens == NULL) return false;
+	chunk->tokens = tokens;
+	TokenValue* values = realloc(chunk->values, cap * sizeof(TokenValue));
+	if (values == NULL) return false;
+	chunk->values = values;
+	chunk->cap = cap;
+	return true;
+}
+
+static bool chunk_push(LexChunk* chunk, Token tok, TokenValue value) {
+	if (chunk->len == chunk->cap && !chunk_reserve(chunk, chunk->cap == 0 ? 256 : chunk->cap * 2)) return false;
+	chunk->tokens[chunk->len] = tok;
+	chunk->values[chunk->len] = value;
+	chunk->len++;
+	return true;
+}
+
+static size_t token_end(const Tokenizer* tokenizer, const Token* tok) {
+	return token_start(tokenizer, tok) - tokenizer->src + token_len(tok);
+}
+
+// lexes every token that starts in [chunk->start, chunk->end), beginning
+// at chunk->start. the last token may run past end.
+static void chunk_lex(const LexJob* job, LexChunk* chunk) {
+	chunk->len = 0;
+	chunk->oom = false;
+
+	// typical sources average well over 4 bytes per token
+	if (chunk->cap == 0 && !chunk_reserve(chunk, (chunk->end - chunk->start) / 4 + 16)) {
+		chunk->oom = true;
+		return;
+	}
+	strpool_clear(&chunk->strings);
+	strpool_clear(&chunk->idents);
+
+	Tokenizer tokenizer;
+	tok_init(&tokenizer, job->src);
+	tokenizer.current = job->src + chunk->start;
+	if (job->strings != NULL) tokenizer.strings = &chunk->strings;
+	if (job->idents != NULL) tokenizer.idents = &chunk->idents;
+
+	bool last = chunk->end == job->len;
+	chunk->stop = chunk->start;
+
+	for (;;) {
+		Token tok = tok_next(&tokenizer);
+		if (tok.type == TOKEN_EOF) {
+			if (last && !chunk_push(chunk, tok, tokenizer.value)) chunk->oom = true;
+			break;
+		}
+
+		size_t start = token_start(&tokenizer, &tok) - job->src;
+		if (start >= chunk->end) break;
+
+		if (!chunk_push(chunk, tok, tokenizer.value)) {
+			chunk->oom = true;
+			break;
+		}
+		chunk->stop = token_end(&tokenizer, &tok);
+	}
+
+	// keep the newlines; offsets are relative to src, as in the output
+	lines_free(&chunk->lines);
+	chunk->lines = tokenizer.lines;
+	lines_init(&tokenizer.lines, job->src);
+	tok_free(&tokenizer);
+}
+
+// the chunk's strings and identifiers move into the caller's pools in
+// token order, which hands out the same ids a serial lex would. done
+// one chunk at a time, in order, after the chunk's tokens are final.
+static bool chunk_intern(const LexJob* job, LexChunk* chunk) {
+	if (job->strings == NULL && job->idents == NULL) return true;
+
+	// local id -> caller's id, or UINT32_MAX if not interned yet
+	size_t strings_len = chunk->strings.len, idents_len = chunk->idents.len;
+	uint32_t* remap = malloc((strings_len + idents_len + 1) * sizeof(uint32_t));
+	if (remap == NULL) return false;
+	memset(remap, 0xff, (strings_len + idents_len) * sizeof(uint32_t));
+
+	for (size_t i = 0; i < chunk->len; i++) {
+		TokenType type = token_type(&chunk->tokens[i]);
+		StrPool* to;
+		const StrPool* from;
+		uint32_t* ids;
+		if (type == TOKEN_LIT_STR && job->strings != NULL) {
+			to = job->strings;
+			from = &chunk->strings;
+			ids = remap;
+		} else if (type == TOKEN_IDENT && job->idents != NULL) {
+			to = job->idents;
+			from = &chunk->idents;
+			ids = &remap[strings_len];
+		} else {
+			continue;
+		}
+
+		StrId* id = &chunk->values[i].str;
+		if (ids[*id] == UINT32_MAX) ids[*id] = strpool_intern(to, strpool_get(from, *id), strpool_len(from, *id));
+		*id = ids[*id];
+	}
+
+	free(remap);
+	return true;
+}
+
+static void job_lex(void* ctx, LexChunk* chunk) {
+	chunk_lex(ctx, chunk);
+}
+
+static void job_copy(void* ctx, LexChunk* chunk) {
+	LexJob* job = ctx;
+	memcpy(&job->out[chunk->out_offset], chunk->tokens, chunk->len * sizeof(Token));
+	memcpy(&job->out_values[chunk->out_offset], chunk->values, chunk->len * sizeof(TokenValue));
+	size_t lines = chunk->lines.len - chunk->lines_from;
+	if (lines > 0) memcpy(&job->out_lines[chunk->lines_out], &chunk->lines.data[chunk->lines_from], lines * sizeof(uint32_t));
+}
+
+static void* job_worker(void* ctx) {
+	LexJob* job = ctx;
+	for (;;) {
+		size_t i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED);
+		if (i >= job->chunks_len) break;
+		job->work(job, &job->chunks[i]);
+	}
+	return NULL;
+}
+
+// runs job->work over every chunk on `threads` threads (the caller is one of them)
+static void job_run(LexJob* job, int threads, void (*work)(void*, LexChunk*)) {
+	job->next = 0;
+	job->work = work;
+
+	pthread_t* tids = threads > 1 ? malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+	int started = 0;
+	if (tids != NULL) {
+		for (; started < threads - 1; started++) {
+			if (pthread_create(&tids[started], NULL, job_worker, job) != 0) break;
+		}
+	}
+
+	job_worker(job);
+
+	for (int i = 0; i < started; i++) pthread_join(tids[i], NULL);
+	free(tids);
+}
+
+bool tok_lex_parallel(const char* src, size_t len, int threads, StrPool* strings, StrPool* idents, TokenList* out) {
+	// lexing stops at the first '\0' in either case
+	len = strnlen(src, len);
+	if (threads < 1) threads = 1;
+
+	size_t chunks_cap = threads == 1 ? 1 : (size_t)threads * TOK_PARALLEL_OVERSPLIT;
+	if (chunks_cap > len / TOK_PARALLEL_MIN_CHUNK) chunks_cap = len / TOK_PARALLEL_MIN_CHUNK;
+	if (chunks_cap < 1) chunks_cap = 1;
+
+	LexChunk* chunks = calloc(chunks_cap, sizeof(LexChunk));
+	if (chunks == NULL) return false;
+	for (size_t i = 0; i < chunks_cap; i++) {
+		strpool_init(&chunks[i].strings);
+		strpool_init(&chunks[i].idents);
+	}
+
+	// split after newlines
+	size_t chunks_len = 0;
+	size_t target = len / chunks_cap;
+	size_t pos = 0;
+	while (pos < len || chunks_len == 0) {
+		size_t end = chunks_len == chunks_cap - 1 ? len : pos + target;
+		if (end >= len) {
+			end = len;
+		} else {
+			const char* nl = memchr(&src[end], '\n', len - end);
+			end = nl == NULL ? len : (size_t)(nl - src) + 1;
+		}
+		chunks[chunks_len].start = pos;
+		chunks[chunks_len].end = end;
+		chunks_len++;
+		pos = end;
+	}
+
+	LexJob job = {
+		.src = src,
+		.len = len,
+		.chunks = chunks,
+		.chunks_len = chunks_len,
+		.strings = strings,
+		.idents = idents,
+	};
+
+	// speculative pass: every chunk assumes it starts between tokens
+	job_run(&job, threads, job_lex);
+
+	// stitch: if a chunk's last token ran into the next chunk, that chunk
+	// started inside a string or comment and is re-lexed from the right place.
+	//
+	// every chunk's tokenizer passed at least up to where the next chunk
+	// starts, so together they saw every '\n'. where they overlap, the
+	// later chunk drops the newlines an earlier one already recorded.
+	bool ok = true;
+	size_t total = 0;
+	size_t total_lines = 0;
+	size_t lines_seen = 0; // newlines before this offset are recorded
+	for (size_t i = 0; i < chunks_len; i++) {
+		LexChunk* chunk = &chunks[i];
+		if (i > 0) {
+			LexChunk* prev = &chunks[i - 1];
+			size_t start = prev->stop > chunk->start ? prev->stop : chunk->start;
+
+			if (start != chunk->start) {
+				chunk->start = start < chunk->end ? start : chunk->end;
+				chunk_lex(&job, chunk);
+				if (start > chunk->end) {
+					// swallowed whole; carry the true end to the next chunk
+					chunk->stop = start;
+				}
+			}
+		}
+		if (chunk->oom || (ok && !chunk_intern(&job, chunk))) ok = false;
+
+		chunk->out_offset = total;
+		total += chunk->len;
+
+		LineIndex* lines = &chunk->lines;
+		chunk->lines_from = 0;
+		while (chunk->lines_from < lines->len && lines->data[chunk->lines_from] < lines_seen) chunk->lines_from++;
+		chunk->lines_out = total_lines;
+		total_lines += lines->len - chunk->lines_from;
+		if (lines->len > chunk->lines_from) lines_seen = lines->data[lines->len - 1] + 1;
+	}
+
+	Token* data = NULL;
+	TokenValue* values = NULL;
+	LineIndex lines;
+	lines_init(&lines, src);
+	if (ok && chunks_len == 1) {
+		// nothing to merge; hand over the chunk's own arrays
+		data = chunks[0].tokens;
+		values = chunks[0].values;
+		chunks[0].tokens = NULL;
+		chunks[0].values = NULL;
+		lines = chunks[0].lines;
+		lines_init(&chunks[0].lines, src);
+	} else if (ok) {
+		data = malloc(total * sizeof(Token));
+		values = malloc(total * sizeof(TokenValue));
+		lines.data = malloc((total_lines > 0 ? total_lines : 1) * sizeof(uint32_t));
+		lines.len = lines.cap = total_lines;
+		if (data != NULL && values != NULL && lines.data != NULL) {
+			job.out = data;
+			job.out_values = values;
+			job.out_lines = lines.data;
+			job_run(&job, threads, job_copy);
+		} else {
+			free(data);
+			free(values);
+			data = NULL;
+		}
+	}
+
+	for (size_t i = 0; i < chunks_len; i++) {
+		free(chunks[i].tokens);
+		free(chunks[i].values);
+		lines_free(&chunks[i].lines);
+		strpool_free(&chunks[i].strings);
+		strpool_free(&chunks[i].idents);
+	}
+	free(chunks);
+
+	if (data == NULL) {
+		lines_free(&lines);
+		return false;
+	}
+	out->data = data;
+	out->values = values;
+	out->len = total;
+	out->lines = lines;
+	return true;
+}
+
+void token_list_free(TokenList* list) {
+	free(list->data);
+	free(list->values);
+	list->data = NULL;
+	list->values = NULL;
+	list->len = 0;
+	lines_free(&list->lines);
+}
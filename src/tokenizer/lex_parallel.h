@@ -0,0 +1,37 @@
+#ifndef _LEX_PARALLEL_H
+#define _LEX_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "tokenizer.h"
+
+struct StrPool;
+
+typedef struct {
+	Token* data;
+	// each token's TokenValue, as tok_next leaves it in Tokenizer.value
+	TokenValue* values;
+	size_t len;
+	// every '\n' in the source, for lines_position
+	LineIndex lines;
+} TokenList;
+
+// lexes all of src (src[len] must be '\0') into out on up to `threads`
+// worker threads. the result is exactly the sequence tok_next would
+// produce, ending with TOKEN_EOF, with the same values and line index.
+// strings and idents play the part of Tokenizer.strings and .idents: if
+// set, string literals and identifiers are interned there, with the ids
+// a serial lex would give them.
+//
+// the buffer is split into chunks at newlines and every chunk is lexed
+// speculatively as if it started between tokens. a chunk that actually
+// starts inside a string or block comment from the previous chunk is
+// detected when the chunks are stitched together and re-lexed from the
+// end of that token. each chunk interns into pools of its own, which are
+// merged into the caller's in order while stitching.
+//
+// returns false if out of memory.
+bool tok_lex_parallel(const char* src, size_t len, int threads, struct StrPool* strings, struct StrPool* idents, TokenList* out);
+void token_list_free(TokenList* list);
+
+#endif
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lines.h"
+
+void lines_init(LineIndex* lines, const char* base) {
+	lines->data = NULL;
+	lines->len = 0;
+	lines->cap = 0;
+	lines->base = base;
+	lines->base_offset = 0;
+}
+
+void lines_free(LineIndex* lines) {
+	free(lines->data);
+	lines->data = NULL;
+	lines->len = 0;
+	lines->cap = 0;
+}
+
+void lines_reset(LineIndex* lines, const char* base) {
+	lines->len = 0;
+	lines->base = base;
+	lines->base_offset = 0;
+}
+
+void lines_grow(LineIndex* lines) {
+	size_t cap = lines->cap == 0 ? 256 : lines->cap * 2;
+	uint32_t* data = realloc(lines->data, cap * sizeof(uint32_t));
+	if (data == NULL) {
+		fprintf(stderr, "lines_grow: out of memory\n");
+		abort();
+	}
+	lines->data = data;
+	lines->cap = cap;
+}
+
+// number of newlines before offset
+static size_t lines_before(const LineIndex* lines, size_t offset) {
+	size_t lo = 0, hi = lines->len;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (lines->data[mid] < offset) lo = mid + 1;
+		else hi = mid;
+	}
+	return lo;
+}
+
+void lines_truncate(LineIndex* lines, size_t offset) {
+	lines->len = lines_before(lines, offset);
+}
+
+SourcePos lines_position(const LineIndex* lines, size_t offset) {
+	size_t line = lines_before(lines, offset);
+	size_t line_start = line == 0 ? 0 : lines->data[line - 1] + 1;
+	return (SourcePos){.line = (int)line, .column = (int)(offset - line_start)};
+}
@@ -0,0 +1,57 @@
+#ifndef _LINES_H
+#define _LINES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 0-based
+typedef struct {
+	int line;
+	int column;
+} SourcePos;
+
+// byte offsets of every '\n' in a source, in order. the tokenizer's
+// scanners record them as they go, so positions cost nothing until a
+// diagnostic asks for one. sources are limited to 4 GiB.
+typedef struct {
+	uint32_t* data;
+	size_t len;
+	size_t cap;
+
+	// a '\n' at p is recorded as p - base + base_offset
+	const char* base;
+	size_t base_offset;
+} LineIndex;
+
+void lines_init(LineIndex* lines, const char* base);
+void lines_free(LineIndex* lines);
+// empties the index for a new source, keeping its capacity
+void lines_reset(LineIndex* lines, const char* base);
+void lines_grow(LineIndex* lines);
+
+static inline void lines_push(LineIndex* lines, const char* p) {
+	if (lines->len == lines->cap) lines_grow(lines);
+	lines->data[lines->len++] = (uint32_t)(p - lines->base + lines->base_offset);
+}
+
+// records a '\n' at block + i for every bit i set in mask. the first
+// one is stored without branching on whether there is one, since the
+// scanners call this for nearly every block and most have none.
+static inline void lines_push_mask(LineIndex* lines, const char* block, uint32_t mask) {
+	if (__builtin_expect(lines->cap - lines->len < 32, 0)) lines_grow(lines);
+
+	uint32_t* out = &lines->data[lines->len];
+	uint32_t offset = (uint32_t)(block - lines->base + lines->base_offset);
+	out[0] = offset + __builtin_ctz(mask | 0x80000000u);
+	lines->len += __builtin_popcount(mask);
+	for (mask &= mask - 1; mask != 0; mask &= mask - 1) *++out = offset + __builtin_ctz(mask);
+}
+
+// drops the newlines at or after offset
+void lines_truncate(LineIndex* lines, size_t offset);
+
+// the position of a byte offset, by binary search. only offsets the
+// scanners have already passed are guaranteed to be right.
+SourcePos lines_position(const LineIndex* lines, size_t offset);
+
+#endif
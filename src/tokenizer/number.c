@@ -0,0 +1,98 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number.h"
+
+bool number_parse_int(const char* src, size_t len, uint64_t* out) {
+	uint64_t value = 0;
+	for (size_t i = 0; i < len; i++) {
+		if (__builtin_mul_overflow(value, 10, &value)) return false;
+		if (__builtin_add_overflow(value, (uint64_t)(src[i] - '0'), &value)) return false;
+	}
+	*out = value;
+	return true;
+}
+
+// every power of ten up to 10^22 is exactly representable as a double
+static const double POW10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define MAX_EXACT_MANTISSA ((uint64_t)1 << 53)
+#define MAX_EXACT_POW10 22
+
+// for literals that don't take the fast path; strtod needs a terminated copy
+static bool number_parse_float_slow(const char* src, size_t len, double* out) {
+	char small[64];
+	char* buf = len < sizeof(small) ? small : malloc(len + 1);
+	if (buf == NULL) {
+		fprintf(stderr, "number_parse_float: out of memory\n");
+		abort();
+	}
+	memcpy(buf, src, len);
+	buf[len] = '\0';
+
+	double value = strtod(buf, NULL);
+	if (buf != small) free(buf);
+
+	if (isinf(value)) return false;
+	*out = value;
+	return true;
+}
+
+bool number_parse_float(const char* src, size_t len, double* out) {
+	// up to 19 significant digits fit in a uint64_t
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exp10 = 0;
+	bool truncated = false;
+	bool dot = false;
+
+	size_t i = 0;
+	for (; i < len && src[i] != 'e'; i++) {
+		char c = src[i];
+		if (c == '.') {
+			dot = true;
+			continue;
+		}
+		if (mantissa == 0 && c == '0') {
+			if (dot) exp10--;
+			continue;
+		}
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (c - '0');
+			digits++;
+			if (dot) exp10--;
+		} else {
+			truncated = true;
+			if (!dot) exp10++;
+		}
+	}
+
+	if (i < len) {
+		// 'e'; clamp so huge exponents can't overflow the int
+		int exp = 0;
+		for (i++; i < len && src[i] >= '0' && src[i] <= '9'; i++) {
+			if (exp < 100000) exp = exp * 10 + (src[i] - '0');
+		}
+		exp10 += exp;
+	}
+
+	if (mantissa == 0) {
+		*out = 0.0;
+		return true;
+	}
+
+	// Clinger's fast path: both the mantissa and the power of ten are exact
+	// doubles, so one correctly rounded multiply or divide gives the result
+	if (!truncated && mantissa <= MAX_EXACT_MANTISSA && exp10 >= -MAX_EXACT_POW10 && exp10 <= MAX_EXACT_POW10) {
+		double value = (double)mantissa;
+		*out = exp10 < 0 ? value / POW10[-exp10] : value * POW10[exp10];
+		return true;
+	}
+
+	return number_parse_float_slow(src, len, out);
+}
@@ -0,0 +1,18 @@
+#ifndef _NUMBER_H
+#define _NUMBER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// decoders for the text of int and float literal tokens.
+// both return false if the value doesn't fit.
+
+// [0-9]+
+bool number_parse_int(const char* src, size_t len, uint64_t* out);
+
+// [0-9]+ ('.' [0-9]*)? ('e' [0-9]+)?, correctly rounded. anything
+// after the exponent digits is ignored, as with strtod.
+bool number_parse_float(const char* src, size_t len, double* out);
+
+#endif
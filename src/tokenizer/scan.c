@@ -0,0 +1,186 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scan.h"
+#include "charclass.h"
+
+// scalar
+
+static const char* scan_whitespace_scalar(const char* p, LineIndex* lines) {
+	for (;; p++) {
+		char c = *p;
+		if (!CHAR_IS(c, CC_SPACE)) break;
+		if (c == '\n') lines_push(lines, p);
+	}
+	return p;
+}
+
+static const char* scan_ident_scalar(const char* p) {
+	while (CHAR_IS(*p, CC_IDENT)) p++;
+	return p;
+}
+
+static const char* scan_string_scalar(const char* p, LineIndex* lines) {
+	for (;; p++) {
+		char c = *p;
+		if (c == '"' || c == '\\' || c == '\0') break;
+		if (c == '\n') lines_push(lines, p);
+	}
+	return p;
+}
+
+static const char* scan_line_comment_scalar(const char* p) {
+	while (*p != '\n' && *p != '\0') p++;
+	return p;
+}
+
+static const char* scan_block_comment_scalar(const char* p, LineIndex* lines) {
+	for (;; p++) {
+		char c = *p;
+		if (c == '*' || c == '\0') break;
+		if (c == '\n') lines_push(lines, p);
+	}
+	return p;
+}
+
+static const ScanImpl SCAN_SCALAR = {
+	.name = "scalar",
+	.whitespace = scan_whitespace_scalar,
+	.ident = scan_ident_scalar,
+	.string = scan_string_scalar,
+	.line_comment = scan_line_comment_scalar,
+	.block_comment = scan_block_comment_scalar,
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+// The vector scanners only ever load whole aligned blocks. An aligned
+// load never crosses a page boundary, so reading the block that contains
+// the terminating '\0' is safe even at the very end of a mapping. Bits for
+// bytes before p in the first block are masked off.
+//
+// Those blocks can start before the buffer and end after it, outside the
+// allocation itself and not just past the last valid byte. That is fine
+// for the hardware but not for AddressSanitizer, so the scanners are
+// built without its checks (SCAN_NO_ASAN).
+//
+// STOP(x) yields a byte mask of the bytes that end the run; RECORD_NL
+// says whether to record the '\n' bytes skipped before the stop byte.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SCAN_NO_ASAN __attribute__((no_sanitize("address")))
+#endif
+#endif
+#if !defined(SCAN_NO_ASAN) && defined(__SANITIZE_ADDRESS__)
+#define SCAN_NO_ASAN __attribute__((no_sanitize("address")))
+#endif
+#ifndef SCAN_NO_ASAN
+#define SCAN_NO_ASAN
+#endif
+
+#define DEFINE_SCAN(isa, name, RECORD_NL, STOP) \
+	static ISA_TARGET_##isa SCAN_NO_ASAN const char* scan_##name##_##isa(const char* p, LineIndex* lines) { \
+		uintptr_t misalign = (uintptr_t)p & (ISA_WIDTH_##isa - 1); \
+		const char* block = p - misalign; \
+		uint32_t live = ~(uint32_t)0 << misalign; \
+		for (;;) { \
+			ISA_VEC_##isa x = ISA_LOAD_##isa(block); \
+			uint32_t stop = (uint32_t)ISA_MOVEMASK_##isa(STOP) & live; \
+			uint32_t lf = RECORD_NL ? (uint32_t)ISA_MOVEMASK_##isa(ISA_EQ_##isa(x, '\n')) & live : 0; \
+			if (stop != 0) lf &= (1u << __builtin_ctz(stop)) - 1; \
+			if (RECORD_NL) lines_push_mask(lines, block, lf); \
+			if (stop != 0) return block + __builtin_ctz(stop); \
+			block += ISA_WIDTH_##isa; \
+			live = ~(uint32_t)0; \
+		} \
+	}
+
+#define DEFINE_SCAN_NO_NL(isa, name) \
+	static ISA_TARGET_##isa const char* scan_##name##_##isa##_no_nl(const char* p) { \
+		return scan_##name##_##isa(p, NULL); \
+	}
+
+#define DEFINE_SCANS(isa) \
+	DEFINE_SCAN(isa, whitespace, 1, \
+		ISA_NOT_##isa(ISA_OR_##isa(ISA_EQ_##isa(x, ' '), ISA_RANGE_##isa(x, '\t', '\r')))) \
+	DEFINE_SCAN(isa, ident, 0, \
+		ISA_NOT_##isa(ISA_OR_##isa( \
+			ISA_OR_##isa(ISA_RANGE_##isa(x, 'a', 'z'), ISA_RANGE_##isa(x, 'A', 'Z')), \
+			ISA_OR_##isa(ISA_RANGE_##isa(x, '0', '9'), ISA_EQ_##isa(x, '_'))))) \
+	DEFINE_SCAN(isa, string, 1, \
+		ISA_OR_##isa(ISA_OR_##isa(ISA_EQ_##isa(x, '"'), ISA_EQ_##isa(x, '\\')), ISA_EQ_##isa(x, '\0'))) \
+	DEFINE_SCAN(isa, line_comment, 0, \
+		ISA_OR_##isa(ISA_EQ_##isa(x, '\n'), ISA_EQ_##isa(x, '\0'))) \
+	DEFINE_SCAN(isa, block_comment, 1, \
+		ISA_OR_##isa(ISA_EQ_##isa(x, '*'), ISA_EQ_##isa(x, '\0'))) \
+	DEFINE_SCAN_NO_NL(isa, ident) \
+	DEFINE_SCAN_NO_NL(isa, line_comment) \
+	static const ScanImpl SCAN_##isa = { \
+		.name = #isa, \
+		.whitespace = scan_whitespace_##isa, \
+		.ident = scan_ident_##isa##_no_nl, \
+		.string = scan_string_##isa, \
+		.line_comment = scan_line_comment_##isa##_no_nl, \
+		.block_comment = scan_block_comment_##isa, \
+	};
+
+// signed byte compares: bytes >= 0x80 are negative and never in range
+#define ISA_TARGET_SSE2 __attribute__((target("sse2")))
+#define ISA_WIDTH_SSE2 16
+#define ISA_VEC_SSE2 __m128i
+#define ISA_LOAD_SSE2(ptr) _mm_load_si128((const __m128i*)(ptr))
+#define ISA_MOVEMASK_SSE2(v) _mm_movemask_epi8(v)
+#define ISA_EQ_SSE2(v, c) _mm_cmpeq_epi8((v), _mm_set1_epi8(c))
+#define ISA_OR_SSE2(a, b) _mm_or_si128((a), (b))
+#define ISA_NOT_SSE2(a) _mm_xor_si128((a), _mm_set1_epi8(-1))
+#define ISA_RANGE_SSE2(v, lo, hi) _mm_and_si128( \
+	_mm_cmpgt_epi8((v), _mm_set1_epi8((lo) - 1)), \
+	_mm_cmplt_epi8((v), _mm_set1_epi8((hi) + 1)))
+
+#define ISA_TARGET_AVX2 __attribute__((target("avx2")))
+#define ISA_WIDTH_AVX2 32
+#define ISA_VEC_AVX2 __m256i
+#define ISA_LOAD_AVX2(ptr) _mm256_load_si256((const __m256i*)(ptr))
+#define ISA_MOVEMASK_AVX2(v) _mm256_movemask_epi8(v)
+#define ISA_EQ_AVX2(v, c) _mm256_cmpeq_epi8((v), _mm256_set1_epi8(c))
+#define ISA_OR_AVX2(a, b) _mm256_or_si256((a), (b))
+#define ISA_NOT_AVX2(a) _mm256_xor_si256((a), _mm256_set1_epi8(-1))
+#define ISA_RANGE_AVX2(v, lo, hi) _mm256_and_si256( \
+	_mm256_cmpgt_epi8((v), _mm256_set1_epi8((lo) - 1)), \
+	_mm256_cmpgt_epi8(_mm256_set1_epi8((hi) + 1), (v)))
+
+DEFINE_SCANS(SSE2)
+DEFINE_SCANS(AVX2)
+
+#undef DEFINE_SCANS
+#undef DEFINE_SCAN_NO_NL
+#undef DEFINE_SCAN
+#undef SCAN_NO_ASAN
+#endif
+
+static const ScanImpl* scan_select(void) {
+	const char* force = getenv("TL_SCAN");
+	if (force != NULL && strcmp(force, "scalar") == 0) return &SCAN_SCALAR;
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init();
+	if (force != NULL && strcmp(force, "sse2") == 0 && __builtin_cpu_supports("sse2")) return &SCAN_SSE2;
+	if (__builtin_cpu_supports("avx2")) return &SCAN_AVX2;
+	if (__builtin_cpu_supports("sse2")) return &SCAN_SSE2;
+#endif
+
+	return &SCAN_SCALAR;
+}
+
+const ScanImpl* scan_impl(void) {
+	static const ScanImpl* impl = NULL;
+
+	const ScanImpl* cached = __atomic_load_n(&impl, __ATOMIC_ACQUIRE);
+	if (cached != NULL) return cached;
+
+	cached = scan_select();
+	__atomic_store_n(&impl, cached, __ATOMIC_RELEASE);
+	return cached;
+}
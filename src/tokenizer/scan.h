@@ -0,0 +1,31 @@
+#ifndef _SCAN_H
+#define _SCAN_H
+
+#include <stddef.h>
+#include "lines.h"
+
+// bulk byte scanners used by the tokenizer. every scanner returns
+// a pointer to the first byte at or after p that ends the run and
+// records every '\n' it skipped in lines (if the scanner takes it).
+// all of them stop at '\0'.
+//
+// the implementation (scalar, SSE2, or AVX2) is chosen at runtime
+// from the cpu; set TL_SCAN=scalar|sse2|avx2 to force one.
+
+typedef struct ScanImpl {
+	const char* name;
+	// stops at the first byte that is not ' ', '\t', '\n', '\v', '\f', '\r'
+	const char* (*whitespace)(const char* p, LineIndex* lines);
+	// stops at the first byte that is not [A-Za-z0-9_]
+	const char* (*ident)(const char* p);
+	// stops at '"', '\\', or '\0'
+	const char* (*string)(const char* p, LineIndex* lines);
+	// stops at '\n' or '\0'
+	const char* (*line_comment)(const char* p);
+	// stops at '*' or '\0'
+	const char* (*block_comment)(const char* p, LineIndex* lines);
+} ScanImpl;
+
+const ScanImpl* scan_impl(void);
+
+#endif
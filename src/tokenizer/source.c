@@ -0,0 +1,117 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "source.h"
+
+#define SOURCE_HEAP_PADDING 64
+
+bool source_open(SourceFile* file, const char* path) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) goto fail;
+
+	if (!S_ISREG(st.st_mode)) {
+		bool ok = source_read_fd(file, fd, path);
+		close(fd);
+		return ok;
+	}
+
+	if ((uint64_t)st.st_size >= SIZE_MAX / 2) {
+		errno = EFBIG;
+		goto fail;
+	}
+
+	size_t len = st.st_size;
+	size_t page = sysconf(_SC_PAGESIZE);
+	// file pages plus one extra page of zeroes for the sentinel
+	size_t map_len = (len + page - 1) / page * page + page;
+
+	// reserve the whole range as zero pages, then map the file over the front.
+	// the kernel zero-fills the tail of the last file page.
+	char* base = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (base == MAP_FAILED) goto fail;
+
+	if (len != 0) {
+		void* mapped = mmap(base, len, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+		if (mapped == MAP_FAILED) {
+			int err = errno;
+			munmap(base, map_len);
+			errno = err;
+			goto fail;
+		}
+		madvise(base, len, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	file->path = path;
+	file->data = base;
+	file->len = len;
+	file->map = base;
+	file->map_len = map_len;
+	return true;
+
+fail:;
+	int err = errno;
+	close(fd);
+	errno = err;
+	return false;
+}
+
+bool source_read_fd(SourceFile* file, int fd, const char* name) {
+	size_t cap = 4096;
+	size_t len = 0;
+	char* buf = malloc(cap + SOURCE_HEAP_PADDING);
+	if (buf == NULL) return false;
+
+	for (;;) {
+		if (len == cap) {
+			cap *= 2;
+			char* grown = realloc(buf, cap + SOURCE_HEAP_PADDING);
+			if (grown == NULL) {
+				free(buf);
+				errno = ENOMEM;
+				return false;
+			}
+			buf = grown;
+		}
+
+		ssize_t n = read(fd, &buf[len], cap - len);
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			int err = errno;
+			free(buf);
+			errno = err;
+			return false;
+		}
+		if (n == 0) break;
+		len += n;
+	}
+	memset(&buf[len], 0, SOURCE_HEAP_PADDING);
+
+	file->path = name;
+	file->data = buf;
+	file->len = len;
+	file->map = NULL;
+	file->map_len = 0;
+	return true;
+}
+
+void source_close(SourceFile* file) {
+	if (file->map != NULL) {
+		munmap(file->map, file->map_len);
+	} else {
+		free((char*)file->data);
+	}
+	file->data = NULL;
+	file->len = 0;
+	file->map = NULL;
+	file->map_len = 0;
+}
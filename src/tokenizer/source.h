@@ -0,0 +1,30 @@
+#ifndef _SOURCE_H
+#define _SOURCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// a source file loaded for lexing. data[len] is always '\0', and at least
+// one zeroed page (or 64 zeroed bytes for non-mappable input) follows the
+// contents, so the tokenizer's '\0' end check and the vector scanners'
+// aligned block loads never touch unmapped memory.
+//
+// regular files are mapped read-only and shared with the page cache;
+// tokens point straight into the mapping.
+typedef struct {
+	const char* path;
+
+	const char* data;
+	size_t len;
+
+	void* map; // NULL if the file was read into a heap buffer instead
+	size_t map_len;
+} SourceFile;
+
+// returns false and sets errno on failure
+bool source_open(SourceFile* file, const char* path);
+// reads a pipe or other non-mappable fd to the end
+bool source_read_fd(SourceFile* file, int fd, const char* name);
+void source_close(SourceFile* file);
+
+#endif
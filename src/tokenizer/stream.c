@@ -0,0 +1,191 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "stream.h"
+
+#define TOK_STREAM_CHUNK (64 * 1024)
+
+// zeroed bytes kept after the data in each buffer, so the terminating
+// '\0' and the aligned block the scanners load around it are allocated
+#define TOK_STREAM_PAD 64
+
+// reads the next chunk, replacing the current one.
+// sets eof (and error, if the read failed) when nothing more comes.
+static void stream_fill(TokStream* stream) {
+	stream->chunk_offset += stream->chunk_len;
+	stream->chunk_len = 0;
+
+	if (!stream->eof) {
+		ssize_t n = stream->read(stream->ctx, stream->chunk, stream->chunk_cap);
+		if (n > 0) {
+			stream->chunk_len = (size_t)n;
+		} else {
+			stream->eof = true;
+			stream->error = n < 0;
+		}
+	}
+	memset(stream->chunk + stream->chunk_len, 0, TOK_STREAM_PAD);
+}
+
+static bool side_append(TokStream* stream, const char* data, size_t len) {
+	if (stream->side_len + len + TOK_STREAM_PAD > stream->side_cap) {
+		size_t cap = stream->side_cap == 0 ? 256 : stream->side_cap;
+		while (cap < stream->side_len + len + TOK_STREAM_PAD) cap *= 2;
+		char* side = realloc(stream->side, cap);
+		if (side == NULL) return false;
+		stream->side = side;
+		stream->side_cap = cap;
+	}
+	memcpy(stream->side + stream->side_len, data, len);
+	stream->side_len += len;
+	memset(stream->side + stream->side_len, 0, TOK_STREAM_PAD);
+	return true;
+}
+
+// moves the token to stream coordinates and remembers its text
+static Token stream_token(TokStream* stream, Token tok, const Tokenizer* tokenizer, size_t base) {
+	stream->text = token_start(tokenizer, &tok);
+	stream->offset = base + (stream->text - tokenizer->src);
+#ifdef TL_COMPACT_TOKENS
+	tok.offset = (uint32_t)stream->offset;
+#endif
+	return tok;
+}
+
+// points the tokenizer (and its line index) at buf, which starts at
+// stream offset `offset`
+static void stream_retarget(Tokenizer* tokenizer, const char* buf, size_t offset) {
+	tokenizer->src = buf;
+	tokenizer->lines.base = buf;
+	tokenizer->lines.base_offset = offset;
+}
+
+// the side buffer couldn't grow; ends the stream with an error token
+static Token stream_oom(TokStream* stream, Token tok) {
+	stream->eof = stream->error = true;
+	tok.type = TOKEN_ERR_GENERIC;
+	return stream_token(stream, tok, &stream->tok, stream->chunk_offset);
+}
+
+bool tok_stream_init(TokStream* stream, TokStreamRead read, void* ctx, size_t chunk_size) {
+	if (chunk_size == 0) chunk_size = TOK_STREAM_CHUNK;
+
+	stream->read = read;
+	stream->ctx = ctx;
+	stream->eof = false;
+	stream->error = false;
+
+	stream->chunk = malloc(chunk_size + TOK_STREAM_PAD);
+	if (stream->chunk == NULL) return false;
+	stream->chunk_cap = chunk_size;
+	stream->chunk_len = 0;
+	stream->chunk_offset = 0;
+	memset(stream->chunk, 0, TOK_STREAM_PAD);
+
+	stream->side = NULL;
+	stream->side_len = 0;
+	stream->side_cap = 0;
+	stream->side_offset = 0;
+
+	tok_init(&stream->tok, stream->chunk);
+	stream->text = stream->chunk;
+	stream->offset = 0;
+	return true;
+}
+
+static Token stream_next(TokStream* stream) {
+	Tokenizer* tokenizer = &stream->tok;
+
+	for (;;) {
+		Token tok = tok_next(tokenizer);
+		size_t start = tokenizer->start - stream->chunk;
+		size_t end = tokenizer->current - stream->chunk;
+
+		// a token that stops short of the chunk's '\0' can't change with more input
+		if (end < stream->chunk_len || stream->eof) {
+			return stream_token(stream, tok, tokenizer, stream->chunk_offset);
+		}
+
+		if (start == stream->chunk_len) {
+			// only whitespace was left
+			stream_fill(stream);
+			stream_retarget(tokenizer, stream->chunk, stream->chunk_offset);
+			tokenizer->current = stream->chunk;
+			continue;
+		}
+
+		// the token reaches the end of the chunk and may continue in the next:
+		// reassemble it in the side buffer, pulling chunks until it ends.
+		// re-lexing can only extend the token, since the bytes before the
+		// old '\0' are unchanged, so it always ends in the newest chunk.
+		stream->side_len = 0;
+		stream->side_offset = stream->chunk_offset + start;
+		if (!side_append(stream, tokenizer->start, stream->chunk_len - start)) return stream_oom(stream, tok);
+
+		for (;;) {
+			stream_fill(stream);
+			if (!side_append(stream, stream->chunk, stream->chunk_len)) return stream_oom(stream, tok);
+
+			// lex from the side buffer, sharing the line index; the newlines
+			// recorded inside the partial token are recorded again
+			lines_truncate(&tokenizer->lines, stream->side_offset);
+			Tokenizer side = *tokenizer;
+			stream_retarget(&side, stream->side, stream->side_offset);
+			side.current = stream->side;
+			tok = tok_next(&side);
+			end = side.current - stream->side;
+			tokenizer->lines = side.lines;
+			stream_retarget(tokenizer, stream->chunk, stream->chunk_offset);
+
+			if (end < stream->side_len || stream->eof) {
+				// resume lexing in the chunk right after the token
+				size_t tail = stream->side_len - stream->chunk_len;
+				tokenizer->current = stream->chunk + (end > tail ? end - tail : 0);
+				tokenizer->value = side.value;
+				return stream_token(stream, tok, &side, stream->side_offset);
+			}
+		}
+	}
+}
+
+Token tok_stream_next(TokStream* stream) {
+	// a token lexed up to the end of a chunk may be cut short and lexed
+	// again, so nothing is interned until the token is whole
+	struct StrPool* strings = stream->tok.strings;
+	struct StrPool* idents = stream->tok.idents;
+	stream->tok.strings = NULL;
+	stream->tok.idents = NULL;
+
+	Token tok = stream_next(stream);
+
+	stream->tok.strings = strings;
+	stream->tok.idents = idents;
+	tok_intern(&stream->tok, token_type(&tok), stream->text, token_len(&tok));
+	return tok;
+}
+
+const char* tok_stream_text(const TokStream* stream) {
+	return stream->text;
+}
+
+size_t tok_stream_offset(const TokStream* stream) {
+	return stream->offset;
+}
+
+void tok_stream_free(TokStream* stream) {
+	tok_free(&stream->tok);
+	free(stream->chunk);
+	free(stream->side);
+	stream->chunk = NULL;
+	stream->side = NULL;
+}
+
+ssize_t tok_stream_read_fd(void* ctx, char* buf, size_t cap) {
+	int fd = *(int*)ctx;
+	for (;;) {
+		ssize_t n = read(fd, buf, cap);
+		if (n >= 0 || errno != EINTR) return n;
+	}
+}
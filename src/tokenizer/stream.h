@@ -0,0 +1,60 @@
+#ifndef _STREAM_H
+#define _STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "tokenizer.h"
+
+// fills buf with up to cap bytes; returns the number of bytes read,
+// 0 at end of input, or < 0 on error.
+typedef ssize_t (*TokStreamRead)(void* ctx, char* buf, size_t cap);
+
+// tokenizes input pulled through a read callback in fixed-size chunks,
+// so memory stays bounded by the chunk size plus the longest token
+// (and the line index, at 4 bytes per line).
+//
+// a token that lies inside one chunk points into it; a token that crosses
+// a chunk boundary is reassembled in a side buffer. either way the token
+// text (tok_stream_text) is only valid until the next tok_stream_next.
+// with TL_COMPACT_TOKENS, Token.offset is the byte offset in the stream.
+// literal values are in tok.value, and tok.strings and tok.idents may be
+// set, as with tok_next.
+typedef struct {
+	TokStreamRead read;
+	void* ctx;
+	bool eof;
+	bool error;
+
+	Tokenizer tok;
+
+	char* chunk;
+	size_t chunk_cap;
+	size_t chunk_len;
+	size_t chunk_offset; // stream offset of chunk[0]
+
+	char* side;
+	size_t side_len;
+	size_t side_cap;
+	size_t side_offset; // stream offset of side[0]
+
+	const char* text;
+	size_t offset;
+} TokStream;
+
+bool tok_stream_init(TokStream* stream, TokStreamRead read, void* ctx, size_t chunk_size);
+Token tok_stream_next(TokStream* stream);
+// text and stream offset of the last token
+const char* tok_stream_text(const TokStream* stream);
+size_t tok_stream_offset(const TokStream* stream);
+
+// line and column of a stream offset that has already been lexed
+static inline SourcePos tok_stream_position(const TokStream* stream, size_t offset) {
+	return tok_position(&stream->tok, offset);
+}
+void tok_stream_free(TokStream* stream);
+
+// TokStreamRead over a file descriptor; ctx points to the int fd
+ssize_t tok_stream_read_fd(void* ctx, char* buf, size_t cap);
+
+#endif
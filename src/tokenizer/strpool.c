@@ -0,0 +1,165 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "strpool.h"
+
+static void* strpool_realloc(void* ptr, size_t size) {
+	void* out = realloc(ptr, size);
+	if (out == NULL) {
+		fprintf(stderr, "strpool: out of memory\n");
+		abort();
+	}
+	return out;
+}
+
+// word at a time; identifiers are mostly a word or two long
+static uint32_t strpool_hash(const char* str, size_t len) {
+	uint64_t hash = len * 0x9e3779b97f4a7c15u;
+	for (; len >= 8; str += 8, len -= 8) {
+		uint64_t word;
+		memcpy(&word, str, 8);
+		hash = (hash ^ word) * 0x9e3779b97f4a7c15u;
+		hash ^= hash >> 32;
+	}
+	if (len > 0) {
+		uint64_t word = 0;
+		memcpy(&word, str, len);
+		hash = (hash ^ word) * 0x9e3779b97f4a7c15u;
+		hash ^= hash >> 32;
+	}
+	return (uint32_t)hash;
+}
+
+void strpool_init(StrPool* pool) {
+	pool->data = NULL;
+	pool->data_len = 0;
+	pool->data_cap = 0;
+	pool->entries = NULL;
+	pool->len = 0;
+	pool->entries_cap = 0;
+	pool->slots = NULL;
+	pool->slots_cap = 0;
+	pool->base = NULL;
+	pool->base_len = 0;
+}
+
+void strpool_init_over(StrPool* pool, const StrPool* base) {
+	strpool_init(pool);
+	pool->base = base;
+	pool->base_len = base->len;
+}
+
+void strpool_free(StrPool* pool) {
+	const StrPool* base = pool->base;
+	free(pool->data);
+	free(pool->entries);
+	free(pool->slots);
+	if (base != NULL) strpool_init_over(pool, base);
+	else strpool_init(pool);
+}
+
+void strpool_clear(StrPool* pool) {
+	pool->data_len = 0;
+	pool->len = 0;
+	if (pool->slots != NULL) memset(pool->slots, 0, pool->slots_cap * sizeof(uint32_t));
+}
+
+static void strpool_grow_slots(StrPool* pool) {
+	size_t cap = pool->slots_cap == 0 ? 64 : pool->slots_cap * 2;
+	uint32_t* slots = calloc(cap, sizeof(uint32_t));
+	if (slots == NULL) {
+		fprintf(stderr, "strpool: out of memory\n");
+		abort();
+	}
+
+	for (size_t index = 0; index < pool->len; index++) {
+		size_t i = pool->entries[index].hash & (cap - 1);
+		while (slots[i] != 0) i = (i + 1) & (cap - 1);
+		slots[i] = index + 1;
+	}
+
+	free(pool->slots);
+	pool->slots = slots;
+	pool->slots_cap = cap;
+}
+
+char* strpool_reserve(StrPool* pool, size_t cap) {
+	// room for the '\0' too; offsets are 32 bits
+	size_t need = pool->data_len + cap + 1;
+	if (need > UINT32_MAX) {
+		fprintf(stderr, "strpool: pool exceeds 4 GiB\n");
+		abort();
+	}
+	if (need > pool->data_cap) {
+		size_t data_cap = pool->data_cap == 0 ? 1024 : pool->data_cap;
+		while (data_cap < need) data_cap *= 2;
+		pool->data = strpool_realloc(pool->data, data_cap);
+		pool->data_cap = data_cap;
+	}
+	return pool->data + pool->data_len;
+}
+
+// returns the slot holding str, or the empty slot where it belongs
+static size_t strpool_probe(const StrPool* pool, const char* str, size_t len, uint32_t hash) {
+	size_t i = hash & (pool->slots_cap - 1);
+	for (; pool->slots[i] != 0; i = (i + 1) & (pool->slots_cap - 1)) {
+		const struct StrPoolEntry* entry = &pool->entries[pool->slots[i] - 1];
+		if (entry->hash == hash && entry->len == len && memcmp(pool->data + entry->offset, str, len) == 0) break;
+	}
+	return i;
+}
+
+// adds the len bytes at the end of data (already reserved) as a new string
+static StrId strpool_append(StrPool* pool, size_t slot, size_t len, uint32_t hash) {
+	if (pool->len == pool->entries_cap) {
+		pool->entries_cap = pool->entries_cap == 0 ? 64 : pool->entries_cap * 2;
+		pool->entries = strpool_realloc(pool->entries, pool->entries_cap * sizeof(struct StrPoolEntry));
+	}
+
+	size_t index = pool->len++;
+	pool->entries[index] = (struct StrPoolEntry){.offset = pool->data_len, .len = len, .hash = hash};
+	pool->slots[slot] = index + 1;
+
+	pool->data[pool->data_len + len] = '\0';
+	pool->data_len += len + 1;
+	return pool->base_len + index;
+}
+
+// true, with its id in *out, if the base pool has str
+static bool strpool_find_base(const StrPool* pool, const char* str, size_t len, uint32_t hash, StrId* out) {
+	if (pool->base_len == 0) return false;
+	size_t slot = strpool_probe(pool->base, str, len, hash);
+	if (pool->base->slots[slot] == 0) return false;
+	*out = pool->base->slots[slot] - 1;
+	return true;
+}
+
+StrId strpool_commit(StrPool* pool, size_t len) {
+	const char* str = pool->data + pool->data_len;
+	uint32_t hash = strpool_hash(str, len);
+	StrId id;
+	if (strpool_find_base(pool, str, len, hash, &id)) return id;
+
+	// keep the table at most half full
+	if ((pool->len + 1) * 2 > pool->slots_cap) strpool_grow_slots(pool);
+
+	size_t slot = strpool_probe(pool, str, len, hash);
+	if (pool->slots[slot] != 0) return pool->base_len + pool->slots[slot] - 1;
+	return strpool_append(pool, slot, len, hash);
+}
+
+StrId strpool_intern(StrPool* pool, const char* str, size_t len) {
+	uint32_t hash = strpool_hash(str, len);
+	StrId id;
+	if (strpool_find_base(pool, str, len, hash, &id)) return id;
+	if ((pool->len + 1) * 2 > pool->slots_cap) strpool_grow_slots(pool);
+
+	// most interned strings are repeats; only copy new ones
+	size_t slot = strpool_probe(pool, str, len, hash);
+	if (pool->slots[slot] != 0) return pool->base_len + pool->slots[slot] - 1;
+
+	memcpy(strpool_reserve(pool, len), str, len);
+	return strpool_append(pool, slot, len, hash);
+}
@@ -0,0 +1,62 @@
+#ifndef _STRPOOL_H
+#define _STRPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t StrId;
+
+// append-only, deduplicated string storage. strings are stored back to
+// back (each followed by a '\0') in one buffer, so the pool doubles as a
+// ready-made constant data section; equal strings share one StrId.
+typedef struct StrPool {
+	char* data;
+	size_t data_len;
+	size_t data_cap;
+
+	struct StrPoolEntry {
+		uint32_t offset;
+		uint32_t len;
+		uint32_t hash;
+	}* entries;
+	size_t len;
+	size_t entries_cap;
+
+	// open addressing; each slot is an index into entries + 1, or 0 if empty
+	uint32_t* slots;
+	size_t slots_cap;
+
+	// read-only pool underneath, or NULL. its strings keep their ids
+	// (below base_len) and are never copied into this one.
+	const struct StrPool* base;
+	uint32_t base_len;
+} StrPool;
+
+void strpool_init(StrPool* pool);
+// an empty pool over base, which must outlive it and not have a base itself
+void strpool_init_over(StrPool* pool, const StrPool* base);
+void strpool_free(StrPool* pool);
+// drops every string (but the base's), keeping the capacity. ids from
+// before are invalid afterwards.
+void strpool_clear(StrPool* pool);
+
+StrId strpool_intern(StrPool* pool, const char* str, size_t len);
+
+// for building a string in place: returns room for up to cap bytes at the
+// end of the pool. write the string there, then intern the first len
+// bytes with strpool_commit. the space is reused if the string is a duplicate.
+char* strpool_reserve(StrPool* pool, size_t cap);
+StrId strpool_commit(StrPool* pool, size_t len);
+
+// '\0'-terminated
+static inline const char* strpool_get(const StrPool* pool, StrId id) {
+	if (id < pool->base_len) return pool->base->data + pool->base->entries[id].offset;
+	return pool->data + pool->entries[id - pool->base_len].offset;
+}
+
+static inline size_t strpool_len(const StrPool* pool, StrId id) {
+	if (id < pool->base_len) return pool->base->entries[id].len;
+	return pool->entries[id - pool->base_len].len;
+}
+
+#endif
@@ -1,21 +1,42 @@
-#include <ctype.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "tokenizer.h"
+#include "scan.h"
+#include "number.h"
+#include "strpool.h"
+#include "charclass.h"
 
 void tok_init(Tokenizer* tokenizer, const char* src) {
+	tokenizer->src = src;
 	tokenizer->start = src;
 	tokenizer->current = src;
-	tokenizer->line = 0;
+	lines_init(&tokenizer->lines, src);
+	tokenizer->scan = scan_impl();
+	tokenizer->value.i = 0;
+	tokenizer->strings = NULL;
+	tokenizer->idents = NULL;
+}
+
+void tok_free(Tokenizer* tokenizer) {
+	lines_free(&tokenizer->lines);
+}
+
+void tok_reset(Tokenizer* tokenizer, const char* src) {
+	tokenizer->src = src;
+	tokenizer->start = src;
+	tokenizer->current = src;
+	lines_reset(&tokenizer->lines, src);
+	tokenizer->value.i = 0;
 }
 
 // increments current and returns the
 // previous value at current.
 static char tok_consume(Tokenizer* tokenizer) {
-	tokenizer->current++;
-	if (tokenizer->current[-1] == '\n') tokenizer->line++;
-	return tokenizer->current[-1];
+	return *tokenizer->current++;
 }
 
 // if tokenizer->current[0] is c, return true
@@ -28,7 +49,11 @@ static bool tok_match(Tokenizer* tokenizer, char c) {
 	return false;
 }
 
-#define MAKE_TOKEN(typ) (Token){.type=(typ),.start=tokenizer->start, .len=tokenizer->current - tokenizer->start, .line=tokenizer->line}
+#ifdef TL_COMPACT_TOKENS
+#define MAKE_TOKEN(typ) (Token){.type=(typ), .offset=tokenizer->start - tokenizer->src, .len=tokenizer->current - tokenizer->start}
+#else
+#define MAKE_TOKEN(typ) (Token){.type=(typ),.start=tokenizer->start, .len=tokenizer->current - tokenizer->start}
+#endif
 
 static Token tok_number(Tokenizer* tokenizer) {
 	bool is_e = false;
@@ -47,12 +72,12 @@ static Token tok_number(Tokenizer* tokenizer) {
 			if (is_dot) goto end;
 			is_dot = true;
 			break;
-		case '0'...'9': break;
-		default: 
-			goto end;
+		default:
+			if (!CHAR_IS(nxt, CC_DIGIT)) goto end;
+			break;
 		}
 
-		tok_consume(tokenizer);
+		tokenizer->current++;
 	}
 	end:
 
@@ -60,80 +85,131 @@ static Token tok_number(Tokenizer* tokenizer) {
 		return MAKE_TOKEN(TOKEN_ERR_FLOAT_REQUIRE_EXP);
 	}
 
-	return MAKE_TOKEN(is_e || is_dot ? TOKEN_LIT_FLOAT : TOKEN_LIT_INT);
+	// decode once here so nothing downstream re-parses the digits
+	const char* start = tokenizer->start;
+	size_t len = tokenizer->current - start;
+	if (is_e || is_dot) {
+		if (!number_parse_float(start, len, &tokenizer->value.f)) return MAKE_TOKEN(TOKEN_ERR_NUMBER_OVERFLOW);
+		return MAKE_TOKEN(TOKEN_LIT_FLOAT);
+	}
+	if (!number_parse_int(start, len, &tokenizer->value.i)) return MAKE_TOKEN(TOKEN_ERR_NUMBER_OVERFLOW);
+	return MAKE_TOKEN(TOKEN_LIT_INT);
+}
+
+// escapes other than \0 and \xHH; 0 if invalid
+static const char ESCAPES[256] = {
+	['n'] = '\n', ['t'] = '\t', ['r'] = '\r',
+	['\\'] = '\\', ['"'] = '"', ['\''] = '\'',
+};
+
+static int hex_digit(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+// unescapes the body of a string literal, which tok_string
+// has already validated, straight into the pool
+static uint32_t tok_intern_string(StrPool* pool, const char* p, const char* end) {
+	char* out = strpool_reserve(pool, end - p);
+	size_t len = 0;
+	for (;;) {
+		const char* backslash = memchr(p, '\\', end - p);
+		size_t run = (backslash != NULL ? backslash : end) - p;
+		memcpy(out + len, p, run);
+		len += run;
+		if (backslash == NULL) break;
+
+		char c = backslash[1];
+		p = backslash + 2;
+		if (c == 'x') {
+			out[len++] = (char)(hex_digit(p[0]) << 4 | hex_digit(p[1]));
+			p += 2;
+		} else {
+			out[len++] = c == '0' ? '\0' : ESCAPES[(uint8_t)c];
+		}
+	}
+	return strpool_commit(pool, len);
 }
 
 static Token tok_string(Tokenizer* tokenizer) {
-	tok_consume(tokenizer); // assume "
+	bool invalid = false;
 
-	while (tokenizer->current[0] != '"') {
+	// the opening '"' was consumed by tok_next
+	for (;;) {
+		tokenizer->current = tokenizer->scan->string(tokenizer->current, &tokenizer->lines);
+		if (tokenizer->current[0] == '"') break;
 		if (tokenizer->current[0] == '\0') return MAKE_TOKEN(TOKEN_ERR_STRING_REQUIRE_TERMINATION);
-		char c = tok_consume(tokenizer);
-		if (c == '\\') {
-			tok_consume(tokenizer);
+
+		tok_consume(tokenizer); // backslash
+		char c = tokenizer->current[0];
+		if (c == '\0') return MAKE_TOKEN(TOKEN_ERR_STRING_REQUIRE_TERMINATION);
+		if (c == '\n') lines_push(&tokenizer->lines, tokenizer->current);
+		tok_consume(tokenizer);
+
+		// keep going to the closing quote, so lexing resumes after the string
+		if (c == 'x') {
+			if (hex_digit(tokenizer->current[0]) < 0 || hex_digit(tokenizer->current[1]) < 0) invalid = true;
+			else tokenizer->current += 2;
+		} else if (c != '0' && ESCAPES[(uint8_t)c] == 0) {
+			invalid = true;
 		}
 	}
 
 	tok_consume(tokenizer);
 
+	if (invalid) return MAKE_TOKEN(TOKEN_ERR_STRING_INVALID_ESCAPE);
+	if (tokenizer->strings != NULL) {
+		tokenizer->value.str = tok_intern_string(tokenizer->strings, tokenizer->start + 1, tokenizer->current - 1);
+	}
 	return MAKE_TOKEN(TOKEN_LIT_STR);
 }
 
 
-static const char* const keywords[] = {
-	"struct",
-	"union",
-	"enum",
-
-	"let",
-	"mut",
-	"const",
-	"type",
-	"func", "return",
+#include "keyword_hash.h"
 
-	"if", "else",
-	"switch", "case",
-	"for", "break", "continue"};
-static const TokenType keyword_tokens[] = {
-	TOKEN_STRUCT, TOKEN_UNION, TOKEN_ENUM,
-	TOKEN_LET, TOKEN_MUT, TOKEN_CONST, TOKEN_TYPE, TOKEN_FUNC, TOKEN_RETURN,
-	TOKEN_IF, TOKEN_ELSE, TOKEN_SWITCH, TOKEN_CASE, TOKEN_FOR, TOKEN_BREAK, TOKEN_CONTINUE
-};
+// perfect hash on (length, first char, last char); see src/gen-keywords.c
+static TokenType tok_keyword(const char* src, size_t len) {
+	if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN) return TOKEN_IDENT;
 
-static bool tok_keyword_match(const char* keyword, const char* src, const char* current) {
-	while (*keyword != '\0') {
-		if (*(keyword++) != *(src++)) return false;
-	}
-	return src == current;
+	size_t slot = KEYWORD_HASH(len, (unsigned char)src[0], (unsigned char)src[len - 1]);
+	if (keyword_lens[slot] != len || memcmp(keywords[slot], src, len) != 0) return TOKEN_IDENT;
+	return keyword_tokens[slot];
 }
 
 static Token tok_ident(Tokenizer* tokenizer) {
-	while (isalnum(tokenizer->current[0]) || tokenizer->current[0] == '_') {
-		tok_consume(tokenizer);
-	}
+	tokenizer->current = tokenizer->scan->ident(tokenizer->current);
 
-	for (int i = 0; i < sizeof (keywords) / sizeof (*keywords); i++) {
-		if (tok_keyword_match(keywords[i], tokenizer->start, tokenizer->current)) {
-			return MAKE_TOKEN(keyword_tokens[i]);
-		}
+	size_t len = tokenizer->current - tokenizer->start;
+	TokenType type = tok_keyword(tokenizer->start, len);
+	if (type == TOKEN_IDENT && tokenizer->idents != NULL) {
+		// hashed while the bytes are still in cache from the scan
+		tokenizer->value.str = strpool_intern(tokenizer->idents, tokenizer->start, len);
 	}
-
-	return MAKE_TOKEN(TOKEN_IDENT);
+	return MAKE_TOKEN(type);
 }
 
 static void tok_skip_whitespace(Tokenizer* tokenizer) {
-	while (isspace(tokenizer->current[0])) tok_consume(tokenizer);
+	// most tokens are separated by a single space; skip the scanner call
+	if (tokenizer->current[0] == ' ' && !CHAR_IS(tokenizer->current[1], CC_SPACE)) {
+		tokenizer->current++;
+		return;
+	}
+	tokenizer->current = tokenizer->scan->whitespace(tokenizer->current, &tokenizer->lines);
 }
 
 static Token tok_comment(Tokenizer* tokenizer) {
 	char c = tok_consume(tokenizer);
 	if (c == '/') {
-		while (tokenizer->current[0] != '\n' && tokenizer->current[0] != '\0') tok_consume(tokenizer);
+		tokenizer->current = tokenizer->scan->line_comment(tokenizer->current);
 		return MAKE_TOKEN(TOKEN_COMMENT);
 	} else {
-		while (!(tokenizer->current[0] == '*' && tokenizer->current[1] == '/')) {
+		for (;;) {
+			tokenizer->current = tokenizer->scan->block_comment(tokenizer->current, &tokenizer->lines);
 			if (tokenizer->current[0] == '\0') return MAKE_TOKEN(TOKEN_ERR_COMMENT_REQUIRE_TERMINATION);
-			tok_consume(tokenizer);
+			if (tokenizer->current[1] == '/') break;
+			tok_consume(tokenizer); // '*'
 		}
 		tok_consume(tokenizer);
 		tok_consume(tokenizer);
@@ -141,64 +217,122 @@ static Token tok_comment(Tokenizer* tokenizer) {
 	}
 }
 
+// first-byte dispatch
+
+static Token tok_eof(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(TOKEN_EOF);
+}
+
+static Token tok_unexpected(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(TOKEN_ERR_UNEXPECTED);
+}
+
+// tokens that are always exactly one byte
+static const uint8_t PUNCT_TOKENS[256] = {
+	['{'] = TOKEN_BRACE_LEFT, ['}'] = TOKEN_BRACE_RIGHT,
+	['['] = TOKEN_BRACKET_LEFT, [']'] = TOKEN_BRACKET_RIGHT,
+	['('] = TOKEN_PAREN_LEFT, [')'] = TOKEN_PAREN_RIGHT,
+	[','] = TOKEN_COMMA, [';'] = TOKEN_SEMICOLON, ['.'] = TOKEN_DOT,
+	['~'] = TOKEN_BIT_NOT, ['?'] = TOKEN_QUESTION,
+};
+
+static Token tok_punct(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(PUNCT_TOKENS[(uint8_t)tokenizer->start[0]]);
+}
+
+// operators that may be followed by '=' (op-assign)
+static const uint8_t OP_TOKENS[256] = {
+	['+'] = TOKEN_ADD, ['-'] = TOKEN_SUB, ['*'] = TOKEN_MUL, ['/'] = TOKEN_DIV, ['%'] = TOKEN_MOD, ['^'] = TOKEN_BIT_XOR,
+	['&'] = TOKEN_BIT_AND, ['|'] = TOKEN_BIT_OR, ['<'] = TOKEN_SHIFT_LEFT, ['>'] = TOKEN_SHIFT_RIGHT,
+};
+static const uint8_t OP_EQ_TOKENS[256] = {
+	['+'] = TOKEN_EQ_ADD, ['-'] = TOKEN_EQ_SUB, ['*'] = TOKEN_EQ_MUL, ['/'] = TOKEN_EQ_DIV, ['%'] = TOKEN_EQ_MOD, ['^'] = TOKEN_EQ_BIT_XOR,
+	['&'] = TOKEN_EQ_BIT_AND, ['|'] = TOKEN_EQ_BIT_OR, ['<'] = TOKEN_EQ_SHIFT_LEFT, ['>'] = TOKEN_EQ_SHIFT_RIGHT,
+};
+
+static Token tok_op(Tokenizer* tokenizer) {
+	uint8_t c = tokenizer->start[0];
+	return MAKE_TOKEN(tok_match(tokenizer, '=') ? OP_EQ_TOKENS[c] : OP_TOKENS[c]);
+}
+
+static Token tok_slash(Tokenizer* tokenizer) {
+	if (*tokenizer->current == '/' || *tokenizer->current == '*') return tok_comment(tokenizer);
+	return tok_op(tokenizer);
+}
+
+// '&&' / '||' or op-assign
+static Token tok_op_doubled(Tokenizer* tokenizer) {
+	char c = tokenizer->start[0];
+	if (tok_match(tokenizer, c)) return MAKE_TOKEN(c == '&' ? TOKEN_BOOL_AND : TOKEN_BOOL_OR);
+	return tok_op(tokenizer);
+}
+
+// '<<' / '>>' (with op-assign), '<=' / '>=', '<' / '>'
+static Token tok_op_angle(Tokenizer* tokenizer) {
+	char c = tokenizer->start[0];
+	if (tok_match(tokenizer, c)) return tok_op(tokenizer);
+	if (tok_match(tokenizer, '=')) return MAKE_TOKEN(c == '<' ? TOKEN_CMP_LE : TOKEN_CMP_GE);
+	return MAKE_TOKEN(c == '<' ? TOKEN_CMP_LT : TOKEN_CMP_GT);
+}
+
+static Token tok_bang(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(tok_match(tokenizer, '=') ? TOKEN_CMP_NE : TOKEN_BOOL_NOT);
+}
+
+static Token tok_eq(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(tok_match(tokenizer, '=') ? TOKEN_CMP_EQ : TOKEN_EQ);
+}
+
+static Token tok_colon(Tokenizer* tokenizer) {
+	return MAKE_TOKEN(tok_match(tokenizer, ':') ? TOKEN_COLONS : TOKEN_COLON);
+}
+
+typedef Token (*TokHandler)(Tokenizer*);
+
+static const TokHandler TOK_DISPATCH[256] = {
+	[0 ... 255] = tok_unexpected,
+	['\0'] = tok_eof,
+
+	['{'] = tok_punct, ['}'] = tok_punct,
+	['['] = tok_punct, [']'] = tok_punct,
+	['('] = tok_punct, [')'] = tok_punct,
+	[','] = tok_punct, [';'] = tok_punct, ['.'] = tok_punct,
+	['~'] = tok_punct, ['?'] = tok_punct,
+	[':'] = tok_colon,
+
+	['+'] = tok_op, ['-'] = tok_op, ['*'] = tok_op, ['%'] = tok_op, ['^'] = tok_op,
+	['/'] = tok_slash,
+	['&'] = tok_op_doubled, ['|'] = tok_op_doubled,
+	['<'] = tok_op_angle, ['>'] = tok_op_angle,
+	['!'] = tok_bang,
+	['='] = tok_eq,
+
+	['0' ... '9'] = tok_number,
+	['"'] = tok_string,
+	['a' ... 'z'] = tok_ident,
+	['A' ... 'Z'] = tok_ident,
+	['_'] = tok_ident,
+};
+
 Token tok_next(Tokenizer* tokenizer) {
 	tok_skip_whitespace(tokenizer);
 
 	tokenizer->start = tokenizer->current;
 
-	char next = tok_consume(tokenizer);
-	switch (next) {
-	#define MATCH(...) tok_match(tokenizer, __VA_ARGS__)
-	case '\0': return MAKE_TOKEN(TOKEN_EOF);
-		
-	case '{': return MAKE_TOKEN(TOKEN_BRACE_LEFT);
-	case '}': return MAKE_TOKEN(TOKEN_BRACE_RIGHT);
-	case '[': return MAKE_TOKEN(TOKEN_BRACKET_LEFT);
-	case ']': return MAKE_TOKEN(TOKEN_BRACKET_RIGHT);
-	case '(': return MAKE_TOKEN(TOKEN_PAREN_LEFT);
-	case ')': return MAKE_TOKEN(TOKEN_PAREN_RIGHT);
-
-	case ',': return MAKE_TOKEN(TOKEN_COMMA);
-	case ';': return MAKE_TOKEN(TOKEN_SEMICOLON);
-	case '.': return MAKE_TOKEN(TOKEN_DOT); 
-	case ':': return MAKE_TOKEN(MATCH(':') ? TOKEN_COLONS : TOKEN_COLON);
-
-	#define OP(name) (tok_match(tokenizer, '=') ? TOKEN_EQ_##name : TOKEN_##name)
-	#define MAKE_OP(name) MAKE_TOKEN(tok_match(tokenizer, '=') ? TOKEN_EQ_##name : TOKEN_##name)
-	case '+': return MAKE_OP(ADD);
-	case '-': return MAKE_OP(SUB);
-	case '*': return MAKE_OP(MUL);
-	case '/': {
-		if (*tokenizer->current == '/' || *tokenizer->current == '*') return tok_comment(tokenizer);
-		return MAKE_OP(DIV);
-	}
-	case '%': return MAKE_OP(MOD);
-	case '&': return MAKE_TOKEN(MATCH('&') ? TOKEN_BOOL_AND : OP(BIT_AND));
-	case '|': return MAKE_TOKEN(MATCH('|') ? TOKEN_BOOL_OR : OP(BIT_OR));
-	case '^': return MAKE_OP(BIT_OR);
-	case '~': return MAKE_TOKEN(TOKEN_BIT_NOT);
-	case '!': return MAKE_TOKEN(MATCH('=') ? TOKEN_CMP_NE : TOKEN_BOOL_NOT);
-	case '=': return MAKE_TOKEN(MATCH('=') ? TOKEN_CMP_EQ : TOKEN_EQ);
-	case '<': return MAKE_TOKEN(
-		MATCH('<') ? OP(SHIFT_LEFT) :
-		MATCH('=') ? TOKEN_CMP_LE : TOKEN_CMP_LT);
-	case '>': return MAKE_TOKEN(
-		MATCH('>') ? OP(SHIFT_RIGHT) :
-		MATCH('=') ? TOKEN_CMP_GE : TOKEN_CMP_GT);
-	case '?': return MAKE_TOKEN(TOKEN_QUESTION);
-
-	case '0'...'9': return tok_number(tokenizer);
-	case '"': return tok_string(tokenizer);
-	case 'A'...'Z':
-	case 'a'...'z':
-	case '_':
-		return tok_ident(tokenizer);
-	default:
-		return MAKE_TOKEN(TOKEN_ERR_UNEXPECTED);
+	// the first byte is never '\n'; whitespace was just skipped
+	uint8_t next = *tokenizer->current++;
+
+	// single-byte punctuation is the most common token; skip the call
+	if (PUNCT_TOKENS[next] != 0) return MAKE_TOKEN(PUNCT_TOKENS[next]);
+	return TOK_DISPATCH[next](tokenizer);
+}
+
+void tok_intern(Tokenizer* tokenizer, TokenType type, const char* text, size_t len) {
+	if (type == TOKEN_IDENT && tokenizer->idents != NULL) {
+		tokenizer->value.str = strpool_intern(tokenizer->idents, text, len);
+	} else if (type == TOKEN_LIT_STR && tokenizer->strings != NULL) {
+		tokenizer->value.str = tok_intern_string(tokenizer->strings, text + 1, text + len - 1);
 	}
-	#undef MATCH
-	#undef OP
-	#undef MAKE_OP
 }
 
 #undef MAKE_TOKEN
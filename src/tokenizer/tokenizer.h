@@ -4,18 +4,47 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "lines.h"
+#include "keywords.h"
+
+struct ScanImpl;
+struct StrPool;
+
+// decoded value of an int (i) or float (f) literal, or the
+// StrId (str) of a string literal or identifier
+typedef union {
+	uint64_t i;
+	double f;
+	uint32_t str;
+} TokenValue;
 
 typedef struct {
+	const char* src;
 	const char* start;
 	const char* current;
-	int line;
+
+	// every '\n' lexed so far; see tok_position
+	LineIndex lines;
+
+	const struct ScanImpl* scan;
+
+	// value of the last TOKEN_LIT_INT, TOKEN_LIT_FLOAT, or (if the
+	// pool below is set) TOKEN_LIT_STR or TOKEN_IDENT returned
+	TokenValue value;
+
+	// if set, string literals are unescaped and interned here
+	struct StrPool* strings;
+	// if set, identifiers are interned here as they are scanned
+	struct StrPool* idents;
 } Tokenizer;
 
 typedef enum {
 	TOKEN_ERR_UNEXPECTED,
 	TOKEN_ERR_FLOAT_REQUIRE_EXP,
 	TOKEN_ERR_STRING_REQUIRE_TERMINATION,
+	TOKEN_ERR_STRING_INVALID_ESCAPE,
 	TOKEN_ERR_COMMENT_REQUIRE_TERMINATION,
+	TOKEN_ERR_NUMBER_OVERFLOW,
 	TOKEN_ERR_GENERIC,
 
 	TOKEN_EOF,
@@ -48,21 +77,74 @@ typedef enum {
 
 	TOKEN_COMMENT, TOKEN_COMMENT_MULTI,
 
-	TOKEN_STRUCT, TOKEN_UNION, TOKEN_ENUM,
-	TOKEN_STATIC, TOKEN_LET, TOKEN_MUT, TOKEN_CONST, TOKEN_TYPE, TOKEN_FUNC, TOKEN_RETURN,
-	TOKEN_IF, TOKEN_ELSE, TOKEN_SWITCH, TOKEN_CASE, TOKEN_FOR, TOKEN_BREAK, TOKEN_CONTINUE
+	// keywords, from keywords.h
+	#define X(keyword, token) token,
+	KEYWORDS(X)
+	#undef X
 } TokenType;
 
+#ifdef TL_COMPACT_TOKENS
+// 12-byte token: the text is recovered from the offset into
+// the tokenizer's source. sources are limited to 4 GiB.
+typedef struct {
+	uint8_t type;
+	uint32_t offset;
+	uint32_t len;
+} Token;
+_Static_assert(sizeof(Token) == 12, "compact Token must be 12 bytes");
+#else
 typedef struct {
 	TokenType type;
 	const char* start;
 	size_t len;
-	int line;
 } Token;
+#endif
 
 
 void tok_init(Tokenizer* tokenizer, const char* src);
+void tok_free(Tokenizer* tokenizer);
+// starts over on src, keeping the line index's capacity and the pools
+void tok_reset(Tokenizer* tokenizer, const char* src);
 Token tok_next(Tokenizer* tokenizer);
+// for a token lexed while strings and idents were unset: interns the
+// text of a TOKEN_IDENT or TOKEN_LIT_STR into the pools now set and
+// updates value, as tok_next would have. other tokens are left alone.
+void tok_intern(Tokenizer* tokenizer, TokenType type, const char* text, size_t len);
+
+// line and column of a byte offset of the source that has already been lexed
+static inline SourcePos tok_position(const Tokenizer* tokenizer, size_t offset) {
+	return lines_position(&tokenizer->lines, offset);
+}
+
+// accessors that work with either token encoding
+
+static inline TokenType token_type(const Token* tok) {
+	return (TokenType)tok->type;
+}
+
+static inline size_t token_len(const Token* tok) {
+	return tok->len;
+}
+
+static inline const char* token_start(const Tokenizer* tokenizer, const Token* tok) {
+#ifdef TL_COMPACT_TOKENS
+	return tokenizer->src + tok->offset;
+#else
+	return tok->start;
+#endif
+}
+
+static inline size_t token_offset(const Tokenizer* tokenizer, const Token* tok) {
+#ifdef TL_COMPACT_TOKENS
+	return tok->offset;
+#else
+	return tok->start - tokenizer->src;
+#endif
+}
+
+static inline SourcePos token_position(const Tokenizer* tokenizer, const Token* tok) {
+	return tok_position(tokenizer, token_offset(tokenizer, tok));
+}
 
 #endif
 